@@ -0,0 +1,248 @@
+#include "radar_defines.h"
+#include "radar_coeffs_gen.h"
+
+// =========================================================
+// 数字下变频前端 (DDC)
+// 实中频 ADC 样点 (速率 f_ADC) -> 复基带 (速率 f_ADC / (2R))，直接送入脉压
+//
+//   x[n] --(*exp(-j*2*pi*fcw*n/2^32))--> CIC (N 级, 抽取 R) --> 补偿 FIR (2 倍抽取) --> 14 位打包
+//
+// - 每个脉冲开始时 NCO 相位、CIC 和 FIR 状态全部清零，各脉冲的处理完全相同 (脉间相参)
+// - 实信号混频后幅度减半，CIC 归一化增益取 2/R^N 补回，满幅中频单音 -> 满幅基带
+// - 补偿 FIR 通带 |f| <= 0.46 f_out，阻带自 0.6 f_out 起 (LFM 扫频 0..0.5 f_out，顶端约 8% 落在过渡带)
+// - 群延迟见 ddc_group_delay()：输出第 j 个样点对应基带时刻 j - delay，
+//   距离门起点需提前 delay 个样点才能与直接输入基带时的距离门对齐
+// =========================================================
+
+static_assert(DDC_FIR_TAPS % 2 == 1, "DDC_FIR_TAPS must be odd");
+static_assert((1 << (DDC_CIC_GROWTH / DDC_CIC_ORDER)) >= DDC_CIC_MAX_R, "DDC_CIC_GROWTH too small");
+
+static const int DDC_NCO_N = 1 << DDC_NCO_LUT_BITS;
+
+// NCO 表即 r=1 的旋转因子表 exp(+j*2*pi*k/N)，混频时取共轭
+static constexpr coeff_gen::table_t<DDC_NCO_N> DDC_NCO_TABLE =
+    coeff_gen::make_sdft_twiddle<DDC_NCO_N>(1.0);
+static const std::complex<ddc_nco_t> (&DDC_NCO_ROM)[DDC_NCO_N] =
+    coeff_gen::rom<std::complex<ddc_nco_t>, DDC_NCO_N, DDC_NCO_TABLE,
+                   std::make_index_sequence<DDC_NCO_N>>::table;
+
+// 补偿 FIR：每个 R 一组系数，[(R-1) * DDC_FIR_TAPS + k]
+static constexpr coeff_gen::table_t<DDC_CIC_MAX_R * DDC_FIR_TAPS> DDC_FIR_TABLE =
+    coeff_gen::make_ddc_fir_bank<DDC_CIC_MAX_R, DDC_FIR_TAPS>(DDC_CIC_ORDER, 0.23, 0.30);
+static const ddc_coef_t (&DDC_FIR_ROM)[DDC_CIC_MAX_R * DDC_FIR_TAPS] =
+    coeff_gen::rom_re<ddc_coef_t, DDC_CIC_MAX_R * DDC_FIR_TAPS, DDC_FIR_TABLE,
+                      std::make_index_sequence<DDC_CIC_MAX_R * DDC_FIR_TAPS>>::table;
+
+// CIC 增益归一化 2 / R^N (R = 1..DDC_CIC_MAX_R)
+static constexpr coeff_gen::table_t<DDC_CIC_MAX_R> make_cic_gain() {
+    coeff_gen::table_t<DDC_CIC_MAX_R> g{};
+    for (int r = 1; r <= DDC_CIC_MAX_R; r++) g.re[r - 1] = 2.0 / coeff_gen::pow_int(r, DDC_CIC_ORDER);
+    return g;
+}
+static constexpr coeff_gen::table_t<DDC_CIC_MAX_R> DDC_GAIN_TABLE = make_cic_gain();
+static const ddc_gain_t (&DDC_GAIN_ROM)[DDC_CIC_MAX_R] =
+    coeff_gen::rom_re<ddc_gain_t, DDC_CIC_MAX_R, DDC_GAIN_TABLE,
+                      std::make_index_sequence<DDC_CIC_MAX_R>>::table;
+
+// 群延迟 (输出样点)：CIC N*(R-1)/2 个输入样点 + FIR (TAPS-1)/2 个 CIC 样点，
+// 再扣除抽取相位 (CIC 取每组第 R-1 个输入，FIR 取奇数 CIC 样点)
+double ddc_group_delay(int r) {
+    double cic = DDC_CIC_ORDER * (r - 1) / 2.0 - (r - 1);          // 输入样点
+    double fir = (DDC_FIR_TAPS - 1) / 2.0 - 1;                     // CIC 样点
+    return (cic + fir * r) / (2.0 * r);
+}
+
+// =========================================================
+// 任务 A: NCO 混频 (中频速率，II=1)
+// =========================================================
+static void ddc_mix(stream_if_t &in, hls::stream<ddc_cplx_t> &out, stream_meta_t &meta_out,
+                    ap_uint<32> fcw, int r, int np) {
+    #pragma HLS INLINE off
+    const int n_if = N_RANGE * 2 * r;
+    for (int p = 0; p < np; p++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=N_PULSE
+        ap_uint<32> phase = 0;
+        for (int i = 0; i < n_if; i++) {
+            #pragma HLS LOOP_TRIPCOUNT min=2*N_RANGE max=2*N_RANGE*DDC_CIC_MAX_R
+            #pragma HLS PIPELINE II=1
+            axis_if_t pkt = in.read();
+            if (i == 0) meta_out.write(pulse_meta_unpack(pkt.user));
+
+            adc_t x;
+            x.range(13, 0) = pkt.data.range(13, 0);
+
+            std::complex<ddc_nco_t> lo = DDC_NCO_ROM[phase.range(31, 32 - DDC_NCO_LUT_BITS)];
+            out.write(ddc_cplx_t(ddc_data_t(x * lo.real()), ddc_data_t(-(x * lo.imag()))));
+            phase += fcw;
+        }
+    }
+}
+
+// =========================================================
+// 任务 B: CIC 抽取 (N 级积分 @ 中频速率，N 级梳状 @ 抽取后速率)
+// 积分器按补码回绕，只要最终输出在范围内，中间回绕不影响结果
+// =========================================================
+static void ddc_cic(hls::stream<ddc_cplx_t> &in, hls::stream<ddc_cplx_t> &out, int r, int np) {
+    #pragma HLS INLINE off
+    const int n_if = N_RANGE * 2 * r;
+    const ddc_gain_t gain = DDC_GAIN_ROM[r - 1];
+    for (int p = 0; p < np; p++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=N_PULSE
+        ddc_cic_t integ_re[DDC_CIC_ORDER], integ_im[DDC_CIC_ORDER];
+        ddc_cic_t comb_re[DDC_CIC_ORDER], comb_im[DDC_CIC_ORDER];
+        #pragma HLS ARRAY_PARTITION variable=integ_re complete
+        #pragma HLS ARRAY_PARTITION variable=integ_im complete
+        #pragma HLS ARRAY_PARTITION variable=comb_re complete
+        #pragma HLS ARRAY_PARTITION variable=comb_im complete
+        for (int s = 0; s < DDC_CIC_ORDER; s++) {
+            #pragma HLS UNROLL
+            integ_re[s] = 0;
+            integ_im[s] = 0;
+            comb_re[s] = 0;
+            comb_im[s] = 0;
+        }
+        int phase = 0;
+        for (int i = 0; i < n_if; i++) {
+            #pragma HLS LOOP_TRIPCOUNT min=2*N_RANGE max=2*N_RANGE*DDC_CIC_MAX_R
+            #pragma HLS PIPELINE II=1
+            ddc_cplx_t x = in.read();
+            ddc_cic_t v_re = x.real(), v_im = x.imag();
+            for (int s = 0; s < DDC_CIC_ORDER; s++) {
+                #pragma HLS UNROLL
+                integ_re[s] += v_re;
+                integ_im[s] += v_im;
+                v_re = integ_re[s];
+                v_im = integ_im[s];
+            }
+            if (phase == r - 1) {
+                for (int s = 0; s < DDC_CIC_ORDER; s++) {
+                    #pragma HLS UNROLL
+                    ddc_cic_t d_re = v_re - comb_re[s], d_im = v_im - comb_im[s];
+                    comb_re[s] = v_re;
+                    comb_im[s] = v_im;
+                    v_re = d_re;
+                    v_im = d_im;
+                }
+                out.write(ddc_cplx_t(ddc_data_t(v_re * gain), ddc_data_t(v_im * gain)));
+                phase = 0;
+            } else {
+                phase++;
+            }
+        }
+    }
+}
+
+// =========================================================
+// 任务 C: 补偿 FIR + 2 倍抽取 (CIC 输出速率，对称系数折叠)
+// =========================================================
+static void ddc_fir(hls::stream<ddc_cplx_t> &in, hls::stream<ddc_cplx_t> &out, int r, int np) {
+    #pragma HLS INLINE off
+    const int base = (r - 1) * DDC_FIR_TAPS;
+    const int M = (DDC_FIR_TAPS - 1) / 2;
+    ddc_coef_t coef[M + 1];
+    #pragma HLS ARRAY_PARTITION variable=coef complete
+    for (int k = 0; k <= M; k++) {
+        coef[k] = DDC_FIR_ROM[base + k];
+    }
+
+    for (int p = 0; p < np; p++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=N_PULSE
+        ddc_cplx_t sr[DDC_FIR_TAPS];
+        #pragma HLS ARRAY_PARTITION variable=sr complete
+        for (int k = 0; k < DDC_FIR_TAPS; k++) {
+            #pragma HLS UNROLL
+            sr[k] = ddc_cplx_t(0, 0);
+        }
+        for (int i = 0; i < 2 * N_RANGE; i++) {
+            #pragma HLS PIPELINE II=1
+            for (int k = DDC_FIR_TAPS - 1; k > 0; k--) {
+                #pragma HLS UNROLL
+                sr[k] = sr[k - 1];
+            }
+            sr[0] = in.read();
+
+            if (i & 1) {
+                ddc_acc_t acc_re = 0, acc_im = 0;
+                for (int k = 0; k < M; k++) {
+                    #pragma HLS UNROLL
+                    ddc_acc_t s_re = (ddc_acc_t)sr[k].real() + sr[DDC_FIR_TAPS - 1 - k].real();
+                    ddc_acc_t s_im = (ddc_acc_t)sr[k].imag() + sr[DDC_FIR_TAPS - 1 - k].imag();
+                    acc_re += s_re * coef[k];
+                    acc_im += s_im * coef[k];
+                }
+                acc_re += sr[M].real() * coef[M];
+                acc_im += sr[M].imag() * coef[M];
+                out.write(ddc_cplx_t(ddc_data_t(acc_re), ddc_data_t(acc_im)));
+            }
+        }
+    }
+}
+
+// =========================================================
+// 任务 D: 打包成 axis_in_t (14 位 RND/SAT，与 input_adaptor 的解析一致)
+// =========================================================
+static void ddc_pack(hls::stream<ddc_cplx_t> &in, stream_meta_t &meta_in, stream_in_t &out, int np) {
+    #pragma HLS INLINE off
+    for (int p = 0; p < np; p++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=N_PULSE
+        ap_uint<PULSE_META_W> user = pulse_meta_pack(meta_in.read());
+        for (int i = 0; i < N_RANGE; i++) {
+            #pragma HLS PIPELINE II=1
+            ddc_cplx_t v = in.read();
+            adc_t re = v.real();
+            adc_t im = v.imag();
+
+            axis_in_t pkt;
+            pkt.data = 0;
+            pkt.data.range(13, 0) = re.range(13, 0);
+            pkt.data.range(29, 16) = im.range(13, 0);
+            pkt.last = (i == N_RANGE - 1);
+            pkt.keep = 0xF;
+            pkt.strb = 0xF;
+            pkt.user = (i == 0) ? user : ap_uint<PULSE_META_W>(0);
+            out.write(pkt);
+        }
+    }
+}
+
+// =========================================================
+// 顶层
+// =========================================================
+void radar_ddc(stream_if_t &if_input, stream_in_t &bb_output, ddc_ctrl_t ctrl, int n_pulse) {
+    #pragma HLS INTERFACE axis port=if_input
+    #pragma HLS INTERFACE axis port=bb_output
+    #pragma HLS INTERFACE ap_none port=ctrl
+    #pragma HLS INTERFACE ap_ctrl_hs port=return
+    #pragma HLS DATAFLOW
+
+    const int r = ddc_ctrl_r(ctrl);
+
+    hls::stream<ddc_cplx_t> mix_s, cic_s, fir_s;
+    stream_meta_t meta_s;
+    #pragma HLS STREAM variable=mix_s depth=4
+    #pragma HLS STREAM variable=cic_s depth=4
+    #pragma HLS STREAM variable=fir_s depth=4
+    #pragma HLS STREAM variable=meta_s depth=4
+
+    ddc_mix(if_input, mix_s, meta_s, ctrl.nco_fcw, r, n_pulse);
+    ddc_cic(mix_s, cic_s, r, n_pulse);
+    ddc_fir(cic_s, fir_s, r, n_pulse);
+    ddc_pack(fir_s, meta_s, bb_output, n_pulse);
+}
+
+// 中频直接进脉压：DDC 与连续脉压在同一 Dataflow 区域，脉压输入速率为 f_ADC / (2R)
+void pulse_compression_ddc(stream_if_t &if_input, stream_out_t &pc_output, stream_meta_t &meta_out,
+                           ddc_ctrl_t ctrl, int n_pulse) {
+    #pragma HLS INTERFACE axis port=if_input
+    #pragma HLS INTERFACE axis port=pc_output
+    #pragma HLS INTERFACE axis port=meta_out
+    #pragma HLS INTERFACE ap_none port=ctrl
+    #pragma HLS INTERFACE ap_ctrl_hs port=return
+    #pragma HLS DATAFLOW
+
+    stream_in_t bb_s;
+    #pragma HLS STREAM variable=bb_s depth=128
+
+    radar_ddc(if_input, bb_s, ctrl, n_pulse);
+    pulse_compression_cpi(bb_s, pc_output, meta_out, n_pulse);
+}
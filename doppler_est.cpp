@@ -1,15 +1,15 @@
 #include "radar_defines.h"
+#include "radar_fft.h"
+#include <hls_math.h>
 
 // 这里的改动非常关键：
 // 1. 移除 static (如果有)
 // 2. 强制 INLINE OFF，切断 FFT 内部逻辑对上层 Dataflow 的干扰
-void doppler_est_top(stream_internal_t &in_stream, stream_internal_t &out_stream) {
+void doppler_est_top(stream_dp_t &in_stream, stream_dp_t &out_stream) {
     #pragma HLS INLINE off
 
     // 1. 配置 FFT
-    hls::ip_fft::config_t<doppler_fft_config> fft_cfg;
-    fft_cfg.setDir(1);
-    fft_cfg.setSch(0x1555);
+    hls::ip_fft::config_t<doppler_fft_config> fft_cfg = radar_fft_cfg<doppler_fft_config>(1, DOP_FFT_SCH);
 
     hls::stream<hls::ip_fft::config_t<doppler_fft_config>> config_strm;
     hls::stream<hls::ip_fft::status_t<doppler_fft_config>> status_strm;
@@ -21,9 +21,189 @@ void doppler_est_top(stream_internal_t &in_stream, stream_internal_t &out_stream
     config_strm.write(fft_cfg);
 
     // 2. 调用 FFT
-    hls::fft<doppler_fft_config>(in_stream, out_stream, status_strm, config_strm);
+    radar_fft<doppler_fft_config>(in_stream, out_stream, status_strm, config_strm);
 
     // 3. 读状态
     hls::ip_fft::status_t<doppler_fft_config> stat;
     status_strm.read(stat);
 }
+
+// ==========================================================================
+// 连续多列多普勒 FFT (Phase 2 流式引擎)
+// 配置 / FFT / 状态拆成三个并行任务，FFT 任务的循环体只剩 hls::fft 调用，
+// pipelined_streaming_io 结构下 N_RANGE 帧首尾相接输入，只有一次填充/排空延迟
+// ==========================================================================
+static void dop_stream_cfg_gen(hls::stream<hls::ip_fft::config_t<doppler_fft_config>> &cfg_strm) {
+    #pragma HLS INLINE off
+    for (int r = 0; r < N_RANGE; r++) {
+        #pragma HLS PIPELINE II=1
+        cfg_strm.write(radar_fft_cfg<doppler_fft_config>(1, DOP_FFT_SCH));
+    }
+}
+
+static void dop_stream_fft(stream_dp_t &in_stream, stream_dp_t &out_stream,
+                           hls::stream<hls::ip_fft::status_t<doppler_fft_config>> &sts_strm,
+                           hls::stream<hls::ip_fft::config_t<doppler_fft_config>> &cfg_strm) {
+    #pragma HLS INLINE off
+    for (int r = 0; r < N_RANGE; r++) {
+        radar_fft<doppler_fft_config>(in_stream, out_stream, sts_strm, cfg_strm);
+    }
+}
+
+static void dop_stream_sts_sink(hls::stream<hls::ip_fft::status_t<doppler_fft_config>> &sts_strm) {
+    #pragma HLS INLINE off
+    for (int r = 0; r < N_RANGE; r++) {
+        #pragma HLS PIPELINE II=1
+        hls::ip_fft::status_t<doppler_fft_config> stat;
+        sts_strm.read(stat);
+    }
+}
+
+void doppler_est_stream(stream_dp_t &in_stream, stream_dp_t &out_stream) {
+    #pragma HLS INLINE off
+    #pragma HLS DATAFLOW
+
+    hls::stream<hls::ip_fft::config_t<doppler_fft_config>> config_strm;
+    hls::stream<hls::ip_fft::status_t<doppler_fft_config>> status_strm;
+    #pragma HLS STREAM variable=config_strm depth=4
+    #pragma HLS STREAM variable=status_strm depth=4
+
+    dop_stream_cfg_gen(config_strm);
+    dop_stream_fft(in_stream, out_stream, status_strm, config_strm);
+    dop_stream_sts_sink(status_strm);
+}
+
+// ==========================================================================
+// 单目标频率估计 (FFT -> 峰值搜索 -> 亚 bin 插值)
+// ==========================================================================
+
+static void dop_status_sink(hls::stream<hls::ip_fft::status_t<doppler_est_fft_config>> &sts_stream) {
+    #pragma HLS INLINE off
+    hls::ip_fft::status_t<doppler_est_fft_config> dummy;
+    sts_stream.read(dummy);
+}
+
+// 峰值功率 (浮点数据通路不缩放，频谱幅度可远超 1)
+#ifdef RADAR_FLOAT_DATAPATH
+typedef float dop_est_pow_t;
+#else
+typedef dop_pow_t dop_est_pow_t;
+#endif
+
+#ifdef RADAR_FLOAT_DATAPATH
+// 定点输入转成浮点送 FFT
+static void dop_est_load(stream_internal_t &in_stream, stream_dp_t &out_stream) {
+    #pragma HLS INLINE off
+    for (int k = 0; k < DOP_EST_NFFT; k++) {
+        #pragma HLS PIPELINE II=1
+        complex_t x = in_stream.read();
+        out_stream.write(dp_complex_t(dp_from_fixed(x.real()), dp_from_fixed(x.imag())));
+    }
+}
+#endif
+
+// 峰值搜索：II=1 流式处理，只保留峰值及左右邻点，不缓存整个频谱
+static void dop_peak_search(stream_dp_t &spec_stream,
+                            hls::stream<dop_peak_t> &peak_stream) {
+    #pragma HLS INLINE off
+    dop_est_pow_t max_pow = 0;
+    dp_complex_t first, prev, left, peak, right;
+    ap_uint<DOP_EST_LOG2N> max_bin = 0;
+    bool need_right = false;
+
+    Peak_Loop: for (int k = 0; k < DOP_EST_NFFT; k++) {
+        #pragma HLS PIPELINE II=1
+        dp_complex_t x = spec_stream.read();
+        dop_est_pow_t pw = x.real() * x.real() + x.imag() * x.imag();
+
+        // 上一个峰值的右邻点
+        if (need_right) {
+            right = x;
+            need_right = false;
+        }
+        if (k == 0) {
+            first = x;
+        }
+        if (k == 0 || pw > max_pow) {
+            max_pow = pw;
+            max_bin = k;
+            left = prev;
+            peak = x;
+            need_right = true;
+        }
+        prev = x;
+    }
+
+    // 频谱首尾循环相接
+    dop_peak_t res;
+    res.bin = max_bin;
+    res.left = (max_bin == 0) ? prev : left;
+    res.peak = peak;
+    res.right = need_right ? first : right;
+    peak_stream.write(res);
+}
+
+// 亚 bin 插值并换算为 Hz (每个驻留只执行一次，用浮点)
+static void dop_peak_interp(hls::stream<dop_peak_t> &peak_stream, float &estimated_freq) {
+    #pragma HLS INLINE off
+    dop_peak_t pk = peak_stream.read();
+
+    float lr = dp_to_float(pk.left.real()),  li = dp_to_float(pk.left.imag());
+    float pr = dp_to_float(pk.peak.real()),  pi = dp_to_float(pk.peak.imag());
+    float rr = dp_to_float(pk.right.real()), ri = dp_to_float(pk.right.imag());
+
+    float delta = 0.0f;
+#if DOP_EST_INTERP == 1
+    // 幅度抛物线插值
+    float a = hls::sqrtf(lr * lr + li * li);
+    float b = hls::sqrtf(pr * pr + pi * pi);
+    float c = hls::sqrtf(rr * rr + ri * ri);
+    float den = a - 2.0f * b + c;
+    if (den != 0.0f) delta = 0.5f * (a - c) / den;
+#elif DOP_EST_INTERP == 2
+    // Jacobsen: delta = Re{(X[k-1] - X[k+1]) / (2X[k] - X[k-1] - X[k+1])}
+    float nr = lr - rr, ni = li - ri;
+    float dr = 2.0f * pr - lr - rr, di = 2.0f * pi - li - ri;
+    float den = dr * dr + di * di;
+    if (den != 0.0f) delta = (nr * dr + ni * di) / den;
+#endif
+
+    // bin >= N/2 对应负频率
+    int k = pk.bin.to_int();
+    if (k >= DOP_EST_NFFT / 2) k -= DOP_EST_NFFT;
+    estimated_freq = ((float)k + delta) * (DOP_EST_FS / DOP_EST_NFFT);
+}
+
+void doppler_est_top(stream_internal_t &in_stream, float &estimated_freq) {
+    #pragma HLS INTERFACE axis port=in_stream
+    #pragma HLS INTERFACE s_axilite port=estimated_freq
+    #pragma HLS INTERFACE ap_ctrl_hs port=return
+    #pragma HLS DATAFLOW
+
+    hls::ip_fft::config_t<doppler_est_fft_config> fft_cfg = radar_fft_cfg<doppler_est_fft_config>(1, DOP_EST_SCH);
+
+    hls::stream<hls::ip_fft::config_t<doppler_est_fft_config>> config_strm;
+    hls::stream<hls::ip_fft::status_t<doppler_est_fft_config>> status_strm;
+    #pragma HLS STREAM variable=config_strm depth=4
+    #pragma HLS STREAM variable=status_strm depth=4
+
+    stream_dp_t spec_strm;
+    hls::stream<dop_peak_t> peak_strm;
+    #pragma HLS STREAM variable=spec_strm depth=16
+    #pragma HLS STREAM variable=peak_strm depth=2
+
+    config_strm.write(fft_cfg);
+
+#ifdef RADAR_FLOAT_DATAPATH
+    stream_dp_t in_dp;
+    #pragma HLS STREAM variable=in_dp depth=16
+    dop_est_load(in_stream, in_dp);
+    radar_fft<doppler_est_fft_config>(in_dp, spec_strm, status_strm, config_strm);
+#else
+    radar_fft<doppler_est_fft_config>(in_stream, spec_strm, status_strm, config_strm);
+#endif
+    dop_status_sink(status_strm);
+
+    dop_peak_search(spec_strm, peak_strm);
+    dop_peak_interp(peak_strm, estimated_freq);
+}
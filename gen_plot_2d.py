@@ -5,6 +5,10 @@ import matplotlib.pyplot as plt
 N_RANGE = 128
 N_PULSE = 128
 
+# 输出顺序 (与 radar_top 的 ctrl 端口一致)
+DOP_MAJOR = False   # True: 多普勒优先 [Dop0_RangeAll, Dop1_RangeAll, ...]
+DOP_SHIFT = False   # True: 多普勒轴已 fftshift，第 k 个 bin 对应 k - N_PULSE/2
+
 # 之前生成的真值，用于图表标题验证
 EXPECTED_RANGE = 50
 EXPECTED_DOPPLER = 32
@@ -30,7 +34,13 @@ def plot_2d_rd_map():
     #   Inner Loop: Pulse/Doppler (0 -> 127)
     # 所以数据流是 [Range0_DopAll, Range1_DopAll, ...]
     # Python reshape 默认是 C-order (行优先)，所以我们 reshape 成 (N_RANGE, N_PULSE)
-    rd_matrix = complex_data.reshape((N_RANGE, N_PULSE))
+    # 多普勒优先时 reshape 成 (N_PULSE, N_RANGE)，.T 只是视图，不做数据搬移
+    if DOP_MAJOR:
+        rd_matrix = complex_data.reshape((N_PULSE, N_RANGE)).T
+    else:
+        rd_matrix = complex_data.reshape((N_RANGE, N_PULSE))
+    # fftshift 后的 bin 编号 (零多普勒居中)
+    dop_base = -N_PULSE // 2 if DOP_SHIFT else 0
 
     # 3. 计算幅度谱 (dB)
     abs_matrix = np.abs(rd_matrix)
@@ -40,14 +50,19 @@ def plot_2d_rd_map():
     # 4. 寻找峰值
     max_idx = np.unravel_index(np.argmax(abs_matrix), abs_matrix.shape)
     peak_range = max_idx[0]
-    peak_doppler = max_idx[1]
+    peak_doppler = max_idx[1] + dop_base
+    if DOP_SHIFT:
+        # 期望值换算到 [-N/2, N/2)
+        expected_doppler = (EXPECTED_DOPPLER + N_PULSE // 2) % N_PULSE - N_PULSE // 2
+    else:
+        expected_doppler = EXPECTED_DOPPLER
     
     print(f"--------------------------------")
     print(f"检测结果:")
     print(f"峰值位置: Range Bin [{peak_range}], Doppler Bin [{peak_doppler}]")
-    print(f"预期位置: Range Bin [{EXPECTED_RANGE}], Doppler Bin [{EXPECTED_DOPPLER}]")
+    print(f"预期位置: Range Bin [{EXPECTED_RANGE}], Doppler Bin [{expected_doppler}]")
     
-    if peak_range == EXPECTED_RANGE and peak_doppler == EXPECTED_DOPPLER:
+    if peak_range == EXPECTED_RANGE and peak_doppler == expected_doppler:
         print(">> 结果判定: PASS (位置完全匹配)")
     else:
         print(">> 结果判定: FAIL (位置偏移)")
@@ -61,7 +76,7 @@ def plot_2d_rd_map():
     # extent参数设置坐标轴范围 [x_min, x_max, y_min, y_max] -> [Doppler, Range]
     # 注意：imshow 的原点默认在左上角，Range通常向上增长，origin='lower' 将原点置于左下
     plt.imshow(db_matrix, aspect='auto', cmap='jet', origin='lower',
-               extent=[0, N_PULSE, 0, N_RANGE])
+               extent=[dop_base, dop_base + N_PULSE, 0, N_RANGE])
     plt.colorbar(label='Amplitude (dB)')
     plt.title(f'Range-Doppler Map (HLS Output)\nPeak @ R:{peak_range}, D:{peak_doppler}')
     plt.xlabel('Doppler Bin (Velocity)')
@@ -73,14 +88,14 @@ def plot_2d_rd_map():
 
     # 子图 2: 峰值切面图 (Range Profile & Doppler Profile)
     plt.subplot(2, 2, 2)
-    plt.plot(db_matrix[:, peak_doppler], 'b-')
+    plt.plot(db_matrix[:, peak_doppler - dop_base], 'b-')
     plt.title(f'Range Profile (at Doppler {peak_doppler})')
     plt.xlabel('Range Bin')
     plt.ylabel('dB')
     plt.grid(True)
 
     plt.subplot(2, 2, 4)
-    plt.plot(db_matrix[peak_range, :], 'r-')
+    plt.plot(np.arange(N_PULSE) + dop_base, db_matrix[peak_range, :], 'r-')
     plt.title(f'Doppler Profile (at Range {peak_range})')
     plt.xlabel('Doppler Bin')
     plt.ylabel('dB')
@@ -0,0 +1,308 @@
+#include "radar_params.h"
+#include "radar_replay.h"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <random>
+#include <thread>
+#include <complex>
+#include <cmath>
+#include <cstdlib>
+#include <climits>
+#include <cstring>
+#include <chrono>
+
+using namespace std;
+
+// =========================================================
+// 多目标场景激励生成器 (替代 gen_data_2d.py 的批量场景)
+// 1. N 个点目标：距离门 / 多普勒 bin (可为小数) / 幅度 / 随机初相
+// 2. 分布杂波：每个距离门一个复高斯散射体，零多普勒附近高斯展宽
+// 3. 热噪声 + 14 位 ADC 量化 (饱和计数)
+// 4. 多线程按帧并行，直接写回放二进制 (radar_replay.h) 和真值列表
+// 5. tb_replay 把回放送入 radar_top，按真值列表自动核对 RD 峰值
+// 只依赖 radar_params.h / radar_replay.h，不需要 HLS 头文件：
+//   g++ -std=c++14 -O2 -pthread gen_scene.cpp -o gen_scene
+//
+// 用法:
+//   gen_scene -f 1000 -o scene.bin --truth truth.csv
+//             -t 50:32:0.5 -t 90:-10.5:0.1   (距离:多普勒:幅度，可重复)
+//             --random 4                      (每帧再加 4 个随机目标)
+//             --noise 0.05 --cnr 20 --clutter-spread 1.0
+//             --text input_stimulus.dat       (第 0 帧文本格式，兼容 tb)
+//             -j 8 --seed 1
+// =========================================================
+
+typedef complex<double> cplx;
+
+struct target_t {
+    double range;     // 距离门，整数 0..N_RANGE-1 (真值列表与合成用同一个值)
+    double doppler;   // 多普勒 bin，可为负数 / 小数
+    double amp;       // 线性幅度 (满量程 = 1)
+};
+
+struct scene_cfg_t {
+    int n_frames = 1;
+    vector<target_t> fixed_targets;
+    int n_random = 0;
+    double rand_amp_db_min = -30.0;
+    double rand_amp_db_max = -6.0;
+    double noise = 0.05;          // 每个分量噪声标准差
+    double cnr_db = -1000.0;      // 单个距离门杂波噪声比 (dB)，默认关闭
+    double clutter_spread = 1.0;  // 杂波多普勒标准差 (bin)
+    int threads = 0;
+    unsigned seed = 1;
+    string out_bin = "scene.bin";
+    string out_truth;
+    string out_text;
+};
+
+struct frame_truth_t {
+    vector<target_t> targets;
+    int clipped = 0;
+};
+
+// LFM 复制品 (与 gen_data_2d.py 相同)
+static vector<cplx> make_lfm() {
+    vector<cplx> s(N_RANGE);
+    double t_pulse = N_RANGE / LFM_FS;
+    double k = LFM_BW / t_pulse;
+    for (int n = 0; n < N_RANGE; n++) {
+        double t = n / LFM_FS;
+        s[n] = polar(1.0, M_PI * k * t * t);
+    }
+    return s;
+}
+
+// ---------------------------------------------------------
+// 单帧合成：逐脉冲构造反射率剖面 h[g]，再与 LFM 做循环卷积
+// ---------------------------------------------------------
+static void synth_frame(const scene_cfg_t &cfg, const vector<cplx> &lfm, int frame,
+                        uint32_t *words, frame_truth_t &truth) {
+    mt19937_64 rng(((uint64_t)cfg.seed << 32) ^ (uint64_t)frame * 0x9E3779B97F4A7C15ULL);
+    normal_distribution<double> gauss(0.0, 1.0);
+    uniform_real_distribution<double> uni(0.0, 1.0);
+
+    // 目标列表 (固定 + 随机)
+    truth.targets = cfg.fixed_targets;
+    for (int i = 0; i < cfg.n_random; i++) {
+        target_t t;
+        t.range = floor(uni(rng) * N_RANGE);
+        t.doppler = uni(rng) * N_PULSE - N_PULSE / 2;
+        double db = cfg.rand_amp_db_min + uni(rng) * (cfg.rand_amp_db_max - cfg.rand_amp_db_min);
+        t.amp = pow(10.0, db / 20.0);
+        truth.targets.push_back(t);
+    }
+    vector<double> phase0(truth.targets.size());
+    for (size_t i = 0; i < phase0.size(); i++) phase0[i] = 2 * M_PI * uni(rng);
+
+    // 杂波：每个距离门的幅度与多普勒
+    bool has_clutter = cfg.cnr_db > -200.0;
+    vector<cplx> clut_amp(N_RANGE);
+    vector<double> clut_dop(N_RANGE);
+    if (has_clutter) {
+        double sigma = cfg.noise * pow(10.0, cfg.cnr_db / 20.0);
+        for (int g = 0; g < N_RANGE; g++) {
+            clut_amp[g] = cplx(gauss(rng), gauss(rng)) * sigma;
+            clut_dop[g] = gauss(rng) * cfg.clutter_spread;
+        }
+    }
+
+    const double scale = (1 << (ADC_BITS - 1)) - 1;
+    vector<cplx> h(N_RANGE);
+    truth.clipped = 0;
+
+    for (int p = 0; p < N_PULSE; p++) {
+        fill(h.begin(), h.end(), cplx(0, 0));
+        for (size_t i = 0; i < truth.targets.size(); i++) {
+            const target_t &t = truth.targets[i];
+            int g = (int)t.range;
+            h[g] += polar(t.amp, phase0[i] + 2 * M_PI * t.doppler * p / N_PULSE);
+        }
+        if (has_clutter) {
+            for (int g = 0; g < N_RANGE; g++) {
+                h[g] += clut_amp[g] * polar(1.0, 2 * M_PI * clut_dop[g] * p / N_PULSE);
+            }
+        }
+
+        for (int n = 0; n < N_RANGE; n++) {
+            cplx acc(0, 0);
+            for (int g = 0; g < N_RANGE; g++) {
+                if (h[g] != cplx(0, 0)) acc += h[g] * lfm[(n - g + N_RANGE) % N_RANGE];
+            }
+            acc += cplx(gauss(rng), gauss(rng)) * cfg.noise;
+
+            // 14 位量化 (与 Python 相同：四舍五入 + 对称饱和)
+            double re = round(acc.real() * scale);
+            double im = round(acc.imag() * scale);
+            if (fabs(re) > scale || fabs(im) > scale) truth.clipped++;
+            re = max(-scale, min(scale, re));
+            im = max(-scale, min(scale, im));
+            words[p * N_RANGE + n] = radar_pack_iq((int)re, (int)im);
+        }
+    }
+}
+
+// 距离门只接受 0..N_RANGE-1 的整数，否则真值列表与实际合成的距离门对不上
+static bool parse_target(const char *s, target_t &t) {
+    char tail;
+    if (sscanf(s, "%lf:%lf:%lf%c", &t.range, &t.doppler, &t.amp, &tail) != 3) return false;
+    return t.range == floor(t.range) && t.range >= 0.0 && t.range < N_RANGE &&
+           std::isfinite(t.doppler) && t.amp >= 0.0;
+}
+
+// 整个参数都要是数字，否则报用法错误 (atoi / atof 会把 "abc" 当成 0)
+static bool parse_int(const char *s, int &v) {
+    char *end;
+    long x = strtol(s, &end, 0);
+    if (end == s || *end != '\0' || x < INT_MIN || x > INT_MAX) return false;
+    v = (int)x;
+    return true;
+}
+
+static bool parse_double(const char *s, double &v) {
+    char *end;
+    v = strtod(s, &end);
+    return end != s && *end == '\0' && std::isfinite(v);
+}
+
+static void usage() {
+    cout << "Usage: gen_scene [-f frames] [-o out.bin] [--truth truth.csv] [--text first_frame.dat]\n"
+            "                 [-t range:doppler:amp]... [--random N] [--amp-db min max]\n"
+            "                 [--noise sigma] [--cnr dB] [--clutter-spread bins] [-j threads] [--seed s]\n"
+            "  range:doppler:amp = range gate (integer 0.." << N_RANGE - 1 << ") : "
+            "Doppler bin (may be negative / fractional) : linear amplitude (>= 0, full scale 1)\n";
+}
+
+int main(int argc, char **argv) {
+    scene_cfg_t cfg;
+    int seed = 1;
+    for (int i = 1; i < argc; i++) {
+        string a = argv[i];
+        bool more = i + 1 < argc;
+        bool ok = true;
+        if ((a == "-f" || a == "--frames") && more) ok = parse_int(argv[++i], cfg.n_frames);
+        else if ((a == "-o" || a == "--out") && more) cfg.out_bin = argv[++i];
+        else if (a == "--truth" && more) cfg.out_truth = argv[++i];
+        else if (a == "--text" && more) cfg.out_text = argv[++i];
+        else if ((a == "-t" || a == "--target") && more) {
+            target_t t;
+            ok = parse_target(argv[++i], t);
+            cfg.fixed_targets.push_back(t);
+        }
+        else if (a == "--random" && more) ok = parse_int(argv[++i], cfg.n_random);
+        else if (a == "--amp-db" && i + 2 < argc) {
+            ok = parse_double(argv[i + 1], cfg.rand_amp_db_min) && parse_double(argv[i + 2], cfg.rand_amp_db_max);
+            i += 2;
+        }
+        else if (a == "--noise" && more) ok = parse_double(argv[++i], cfg.noise);
+        else if (a == "--cnr" && more) ok = parse_double(argv[++i], cfg.cnr_db);
+        else if (a == "--clutter-spread" && more) ok = parse_double(argv[++i], cfg.clutter_spread);
+        else if (a == "-j" && more) ok = parse_int(argv[++i], cfg.threads);
+        else if (a == "--seed" && more) ok = parse_int(argv[++i], seed);
+        else if (a == "-h" || a == "--help") { usage(); return 0; }
+        else ok = false;
+        if (!ok) {
+            cout << "ERROR: Bad or incomplete argument '" << a << "'" << endl;
+            usage();
+            return 1;
+        }
+    }
+    cfg.seed = (unsigned)seed;
+    const char *bad = 0;
+    if (cfg.n_frames < 1) bad = "frames must be >= 1";
+    else if (cfg.n_random < 0) bad = "--random must be >= 0";
+    else if (cfg.threads < 0) bad = "-j must be >= 0 (0 = all hardware threads)";
+    else if (cfg.noise < 0.0 || cfg.clutter_spread < 0.0) bad = "--noise / --clutter-spread must be >= 0";
+    else if (cfg.rand_amp_db_min > cfg.rand_amp_db_max) bad = "--amp-db min must not exceed max";
+    if (bad) {
+        cout << "ERROR: " << bad << endl;
+        usage();
+        return 1;
+    }
+    if (cfg.fixed_targets.empty() && cfg.n_random == 0) {
+        // 默认场景与 gen_data_2d.py 相同
+        target_t t = {50, 32, 1.0};
+        cfg.fixed_targets.push_back(t);
+    }
+    int nt = cfg.threads > 0 ? cfg.threads : (int)thread::hardware_concurrency();
+    if (nt <= 0) nt = 1;
+
+    FILE *fp = fopen(cfg.out_bin.c_str(), "wb");
+    if (!fp) {
+        cout << "ERROR: Cannot create " << cfg.out_bin << endl;
+        return 1;
+    }
+    if (!radar_replay_write_header(fp, N_RANGE, N_PULSE, cfg.n_frames)) {
+        cout << "ERROR: Write to " << cfg.out_bin << " failed" << endl;
+        fclose(fp);
+        return 1;
+    }
+
+    ofstream truth_file;
+    if (!cfg.out_truth.empty()) {
+        truth_file.open(cfg.out_truth.c_str());
+        truth_file << "frame,target,range_bin,doppler_bin,amplitude,clipped_samples" << endl;
+    }
+
+    cout << ">> [GEN] " << cfg.n_frames << " frames, " << cfg.fixed_targets.size() << " fixed + "
+         << cfg.n_random << " random targets, " << nt << " threads" << endl;
+
+    const vector<cplx> lfm = make_lfm();
+    const int words_per_frame = N_PULSE * N_RANGE;
+    const int batch = nt * 4;  // 每批帧数：线程并行生成，主线程按序写盘
+    vector<uint32_t> buf((size_t)batch * words_per_frame);
+    vector<frame_truth_t> truths(batch);
+    long total_clipped = 0;
+
+    auto t0 = chrono::steady_clock::now();
+    for (int f0 = 0; f0 < cfg.n_frames; f0 += batch) {
+        int nb = min(batch, cfg.n_frames - f0);
+        vector<thread> pool;
+        for (int w = 0; w < nt; w++) {
+            pool.push_back(thread([&, w] {
+                for (int k = w; k < nb; k += nt) {
+                    synth_frame(cfg, lfm, f0 + k, &buf[(size_t)k * words_per_frame], truths[k]);
+                }
+            }));
+        }
+        for (size_t w = 0; w < pool.size(); w++) pool[w].join();
+
+        if (fwrite(buf.data(), sizeof(uint32_t), (size_t)nb * words_per_frame, fp) != (size_t)nb * words_per_frame) {
+            cout << "ERROR: Write to " << cfg.out_bin << " failed" << endl;
+            fclose(fp);
+            return 1;
+        }
+
+        for (int k = 0; k < nb; k++) {
+            total_clipped += truths[k].clipped;
+            if (truth_file.is_open()) {
+                for (size_t i = 0; i < truths[k].targets.size(); i++) {
+                    const target_t &t = truths[k].targets[i];
+                    truth_file << f0 + k << "," << i << "," << t.range << "," << t.doppler << ","
+                               << t.amp << "," << truths[k].clipped << "\n";
+                }
+            }
+        }
+
+        // 第 0 帧另存为文本，直接给 tb_compression_dop 使用
+        if (f0 == 0 && !cfg.out_text.empty()) {
+            ofstream txt(cfg.out_text.c_str());
+            for (int i = 0; i < words_per_frame; i++) {
+                int re, im;
+                radar_unpack_iq(buf[i], re, im);
+                txt << re << " " << im << "\n";
+            }
+        }
+    }
+    fclose(fp);
+    auto t1 = chrono::steady_clock::now();
+
+    double sec = chrono::duration<double>(t1 - t0).count();
+    cout << ">> [GEN] Done in " << sec << " s (" << cfg.n_frames / sec << " frames/s)" << endl;
+    if (total_clipped > 0) {
+        cout << ">> [GEN] WARNING: " << total_clipped << " samples clipped by ADC quantization" << endl;
+    }
+    return 0;
+}
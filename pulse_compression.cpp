@@ -1,61 +1,118 @@
 #include "radar_defines.h"
+#include "radar_fft.h"
+#include <cmath>
 
 // ==========================================================================
 // 0. 系数定义
 // ==========================================================================
-#if __has_include("radar_coeffs.h")
-    static const complex_coeff_t REF_COEFFS[N_RANGE] = {
+#if defined(RADAR_COEFFS_FROM_FILE)
+  #if __has_include("radar_coeffs.h")
+    static const dp_complex_t REF_COEFFS[N_RANGE] = {
         #include "radar_coeffs.h"
     };
-#else
+  #else
     #error "Generate radar_coeffs.h using Python script first!"
+  #endif
+#else
+    // 编译期由 (LFM_BW, LFM_FS, N_RANGE) 生成，综合为 ROM (浮点数据通路时为 float ROM)
+    #include "radar_coeffs_gen.h"
+    static const dp_complex_t (&REF_COEFFS)[N_RANGE] =
+        coeff_gen::rom<dp_complex_t, N_RANGE, RADAR_MF_TABLE,
+                       std::make_index_sequence<N_RANGE>>::table;
 #endif
 
 // ==========================================================================
 // 辅助函数：Status 垃圾桶
+// 以下各阶段均以 np (每次调用处理的脉冲数) 为参数：
+//   np = 1       : pulse_compression，单脉冲
+//   np = n_pulse : pulse_compression_cpi，整个 CPI 首尾相接流过 (运行时 <= N_PULSE，
+//                  radar_top 预积累时为输入脉冲数 <= PRESUM_MAX_PULSES)
 // ==========================================================================
-static void status_sink(hls::stream<hls::ip_fft::status_t<fft_config>> &sts_stream) {
+static void status_sink(hls::stream<hls::ip_fft::status_t<fft_config>> &sts_stream, int np) {
+    #pragma HLS INLINE off
+    for (int p = 0; p < np; p++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=PRESUM_MAX_PULSES
+        hls::ip_fft::status_t<fft_config> dummy;
+        sts_stream.read(dummy); // 阻塞读取
+    }
+}
+
+// 配置流：每个脉冲一个配置字，一次性写完，不打断数据流
+static void fft_config_gen(hls::stream<hls::ip_fft::config_t<fft_config>> &cfg_stream,
+                           bool fwd, unsigned sch, int np) {
+    #pragma HLS INLINE off
+    for (int p = 0; p < np; p++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=PRESUM_MAX_PULSES
+        #pragma HLS PIPELINE II=1
+        cfg_stream.write(radar_fft_cfg<fft_config>(fwd, sch));
+    }
+}
+
+// FFT 任务：循环体只有 hls::fft 调用，脉冲之间不排空
+static void fft_frames(stream_dp_t &in, stream_dp_t &out,
+                       hls::stream<hls::ip_fft::status_t<fft_config>> &sts_stream,
+                       hls::stream<hls::ip_fft::config_t<fft_config>> &cfg_stream, int np) {
     #pragma HLS INLINE off
-    hls::ip_fft::status_t<fft_config> dummy;
-    sts_stream.read(dummy); // 阻塞读取
+    for (int p = 0; p < np; p++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=PRESUM_MAX_PULSES
+        radar_fft<fft_config>(in, out, sts_stream, cfg_stream);
+    }
 }
 
 // ==========================================================================
 // 1. 输入转换与量化 (位拷贝修复版)
 // ==========================================================================
-static void input_adaptor(stream_in_t &in, hls::stream<complex_t> &out) {
-    #pragma HLS INLINE off
-    for (int i = 0; i < N_RANGE; i++) {
-        #pragma HLS PIPELINE II=1
+static dp_complex_t adc_unpack(const axis_in_t &pkt) {
+    #pragma HLS INLINE
+    // 解析 14位 ADC 数据
+    ap_int<14> raw_re = pkt.data.range(13, 0);
+    ap_int<14> raw_im = pkt.data.range(29, 16);
+
+    // 【关键修复】使用位拷贝，而非数学除法
+    // 整数 8191 (0x1FFF) -> 定点数 0.999 (0x1FFF)
+    // 这样既避开了编译报错，又防止了数值饱和归零
+    adc_t re_adc;
+    adc_t im_adc;
 
-        axis_in_t pkt = in.read();
+    re_adc.range(13, 0) = raw_re.range(13, 0);
+    im_adc.range(13, 0) = raw_im.range(13, 0);
 
-        // 解析 14位 ADC 数据
-        ap_int<14> raw_re = pkt.data.range(13, 0);
-        ap_int<14> raw_im = pkt.data.range(29, 16);
+    return dp_complex_t(dp_from_fixed(re_adc), dp_from_fixed(im_adc));
+}
+
+// 脉冲边界按 TLAST 重同步 (rx_sync_t)：短包补零、长包截断，下一个脉冲照常对齐，不需要复位
+// per_pulse 为调用方给出的 TLAST 约定；元数据在脉冲读完后写出，带上本脉冲的 rx_err
+static void input_adaptor(stream_in_t &in, stream_dp_t &out, stream_meta_t &meta_out, int np, bool per_pulse) {
+    #pragma HLS INLINE off
+    rx_sync_t sync;
+    rx_sync_init(sync, per_pulse);
+    for (int p = 0; p < np; p++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=PRESUM_MAX_PULSES
+        pulse_meta_t meta;
+        for (int i = 0; i < N_RANGE; i++) {
+            #pragma HLS PIPELINE II=1
 
-        // 【关键修复】使用位拷贝，而非数学除法
-        // 整数 8191 (0x1FFF) -> 定点数 0.999 (0x1FFF)
-        // 这样既避开了编译报错，又防止了数值饱和归零
-        adc_t re_adc;
-        adc_t im_adc;
+            axis_in_t pkt = rx_sync_beat(in, sync, i);
 
-        re_adc.range(13, 0) = raw_re.range(13, 0);
-        im_adc.range(13, 0) = raw_im.range(13, 0);
+            // 脉冲元数据只在第一个样点有效
+            if (i == 0) meta = pulse_meta_unpack(pkt.user);
 
-        out.write(complex_t((fft_data_t)re_adc, (fft_data_t)im_adc));
+            out.write(adc_unpack(pkt));
+        }
+        meta.rx_err = rx_sync_end(in, sync, p == np - 1);
+        meta_out.write(meta);
     }
 }
 
 // ==========================================================================
 // 2. 核心处理 (并行流水线)
 // ==========================================================================
-static void processing_core(hls::stream<complex_t> &in, hls::stream<complex_t> &out) {
+static void processing_core(stream_dp_t &in, stream_dp_t &out, int np) {
     #pragma HLS INLINE off
     #pragma HLS DATAFLOW
 
     // 内部流与深度
-    hls::stream<complex_t> fft_in, fft_out, mult_out, ifft_out;
+    stream_dp_t fft_in, fft_out, mult_out, ifft_out;
     #pragma HLS STREAM variable=fft_in depth=128
     #pragma HLS STREAM variable=fft_out depth=128
     #pragma HLS STREAM variable=mult_out depth=128
@@ -64,79 +121,242 @@ static void processing_core(hls::stream<complex_t> &in, hls::stream<complex_t> &
     // 配置与状态流
     hls::stream<hls::ip_fft::config_t<fft_config>> fft_cfg, ifft_cfg;
     hls::stream<hls::ip_fft::status_t<fft_config>> fft_sts, ifft_sts;
+    #pragma HLS STREAM variable=fft_cfg depth=4
+    #pragma HLS STREAM variable=ifft_cfg depth=4
     #pragma HLS STREAM variable=fft_sts depth=16
     #pragma HLS STREAM variable=ifft_sts depth=16
 
     // 写配置
-    hls::ip_fft::config_t<fft_config> cfg1, cfg2;
-    cfg1.setDir(1); cfg1.setSch(0x6A); fft_cfg.write(cfg1);
-    cfg2.setDir(0); cfg2.setSch(0x55); ifft_cfg.write(cfg2);
+    fft_config_gen(fft_cfg, 1, PC_FFT_SCH, np);
+    fft_config_gen(ifft_cfg, 0, PC_IFFT_SCH, np);
 
     // --- Dataflow Stages ---
 
     // Stage A: 将输入转入 FFT 流
-    for(int i=0; i<N_RANGE; i++) {
+    for(int i=0; i<np*N_RANGE; i++) {
         #pragma HLS PIPELINE II=1
+        #pragma HLS LOOP_TRIPCOUNT min=N_RANGE max=PRESUM_MAX_PULSES*N_RANGE
         fft_in.write(in.read());
     }
 
     // Stage B: Forward FFT
-    hls::fft<fft_config>(fft_in, fft_out, fft_sts, fft_cfg);
-    status_sink(fft_sts);
+    fft_frames(fft_in, fft_out, fft_sts, fft_cfg, np);
+    status_sink(fft_sts, np);
 
     // Stage C: 频域相乘 (匹配滤波)
-    for(int i=0; i<N_RANGE; i++) {
-        #pragma HLS PIPELINE II=1
-        complex_t val = fft_out.read();
-        complex_t res = val * REF_COEFFS[i];
-        mult_out.write(res);
+    for(int p=0; p<np; p++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=PRESUM_MAX_PULSES
+        for(int i=0; i<N_RANGE; i++) {
+            #pragma HLS PIPELINE II=1
+            dp_complex_t val = fft_out.read();
+            dp_complex_t res = val * REF_COEFFS[i];
+            mult_out.write(res);
+        }
     }
 
     // Stage D: Inverse FFT
-    hls::fft<fft_config>(mult_out, ifft_out, ifft_sts, ifft_cfg);
-    status_sink(ifft_sts);
+    fft_frames(mult_out, ifft_out, ifft_sts, ifft_cfg, np);
+    status_sink(ifft_sts, np);
 
     // Stage E: 输出
-    for(int i=0; i<N_RANGE; i++) {
+    for(int i=0; i<np*N_RANGE; i++) {
         #pragma HLS PIPELINE II=1
+        #pragma HLS LOOP_TRIPCOUNT min=N_RANGE max=PRESUM_MAX_PULSES*N_RANGE
         out.write(ifft_out.read());
     }
 }
 
 // ==========================================================================
-// 3. 输出适配
+// 2b. 短码时域匹配滤波 (pulse_compression_fir 中代替 processing_core)
+// 直接型 FIR：移位寄存器 sr[j] = x[t-j]，每个抽头一个复数乘，乘积全并行求和，II=1
+// 抽头在调用开始时倒序载入寄存器 (g[j] = taps[n_taps-1-j])，第 i 门在 x[i+n_taps-1] 到达时输出，
+// 延迟为 n_taps-1 个样点加乘加流水线 (几十个周期)，不需要 FFT 的整帧缓存
+// 寄存器中越过本脉冲末尾的样点属于下一个脉冲，按门号屏蔽；最后一个脉冲之后补 n_taps-1 个零排空
 // ==========================================================================
-static void output_adaptor(hls::stream<complex_t> &in, stream_out_t &out) {
+static dp_data_t fir_scale(pc_fir_acc_t s) {
+#ifdef RADAR_FLOAT_DATAPATH
+    // output_adaptor 再乘 2^-PC_DP_SHIFT，结果与定点版本同一刻度
+    return std::ldexp(s, PC_DP_SHIFT - PC_FIR_SHIFT);
+#else
+    return ap_fixed<16, 1, AP_RND, AP_SAT>(s >> PC_FIR_SHIFT);
+#endif
+}
+
+static void fir_core(stream_dp_t &in, stream_dp_t &out,
+                     const pc_fir_tap_t taps[PC_FIR_MAX_TAPS], int n_taps, int np) {
     #pragma HLS INLINE off
-    for (int i = 0; i < N_RANGE; i++) {
+    std::complex<pc_fir_coef_t> g[PC_FIR_MAX_TAPS];
+    dp_complex_t sr[PC_FIR_MAX_TAPS];
+    #pragma HLS ARRAY_PARTITION variable=g complete
+    #pragma HLS ARRAY_PARTITION variable=sr complete
+
+    const int nt = (n_taps <= 0 || n_taps > PC_FIR_MAX_TAPS) ? PC_FIR_MAX_TAPS : n_taps;
+    Fir_Load_Loop: for (int j = 0; j < PC_FIR_MAX_TAPS; j++) {
+        #pragma HLS PIPELINE II=1
+        pc_fir_tap_t h = (j < nt) ? taps[nt - 1 - j] : pc_fir_tap_t(0, 0);
+        g[j] = std::complex<pc_fir_coef_t>((pc_fir_coef_t)h.real(), (pc_fir_coef_t)h.imag());
+        sr[j] = dp_complex_t(0, 0);
+    }
+
+    const int n_in = np * N_RANGE;
+    int gate = 0;
+    Fir_Sample_Loop: for (int t = 0; t < n_in + nt - 1; t++) {
+        #pragma HLS LOOP_TRIPCOUNT min=N_RANGE max=PRESUM_MAX_PULSES*N_RANGE+PC_FIR_MAX_TAPS-1
         #pragma HLS PIPELINE II=1
-        complex_t val = in.read();
-
-        axis_out_t pkt;
-        pkt.data.re = val.real();
-        pkt.data.im = val.imag();
-        pkt.last = (i == N_RANGE - 1) ? 1 : 0;
-        pkt.keep = -1;
-        pkt.strb = -1;
-        out.write(pkt);
+        Fir_Shift_Loop: for (int j = PC_FIR_MAX_TAPS - 1; j > 0; j--) {
+            #pragma HLS UNROLL
+            sr[j] = sr[j - 1];
+        }
+        sr[0] = (t < n_in) ? in.read() : dp_complex_t(0, 0);
+
+        if (t >= nt - 1) {
+            pc_fir_acc_t acc_re = 0, acc_im = 0;
+            Fir_Mac_Loop: for (int j = 0; j < PC_FIR_MAX_TAPS; j++) {
+                #pragma HLS UNROLL
+                // sr[j] = x[gate + nt-1-j]
+                if (gate + nt - 1 - j < N_RANGE) {
+                    acc_re += sr[j].real() * g[j].real() - sr[j].imag() * g[j].imag();
+                    acc_im += sr[j].real() * g[j].imag() + sr[j].imag() * g[j].real();
+                }
+            }
+            out.write(dp_complex_t(fir_scale(acc_re), fir_scale(acc_im)));
+            gate = (gate == N_RANGE - 1) ? 0 : gate + 1;
+        }
+    }
+}
+
+// Phase 1 脉压核：n_taps 逐 CPI 选择 FFT 匹配滤波或短码 FIR，两个核都综合
+static void pc_core(stream_dp_t &in, stream_dp_t &out,
+                    const pc_fir_tap_t taps[PC_FIR_MAX_TAPS], int n_taps, int np) {
+    #pragma HLS INLINE off
+    if (n_taps > 0) {
+        fir_core(in, out, taps, n_taps, np);
+    } else {
+        processing_core(in, out, np);
+    }
+}
+
+// ==========================================================================
+// 3. 输出适配 (TLAST 标记每个脉冲的最后一个样点)
+// 浮点数据通路在这里换回 16 位 (与定点版本同一刻度)
+// ==========================================================================
+static void output_adaptor(stream_dp_t &in, stream_out_t &out, int np) {
+    #pragma HLS INLINE off
+    for (int p = 0; p < np; p++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=PRESUM_MAX_PULSES
+        for (int i = 0; i < N_RANGE; i++) {
+            #pragma HLS PIPELINE II=1
+            complex_t val = dp_to_fixed<PC_DP_SHIFT>(in.read());
+
+            axis_out_t pkt;
+            pkt.data.re = val.real();
+            pkt.data.im = val.imag();
+            pkt.last = (i == N_RANGE - 1) ? 1 : 0;
+            pkt.keep = -1;
+            pkt.strb = -1;
+            out.write(pkt);
+        }
     }
 }
 
 // ==========================================================================
 // 4. 顶层函数
 // ==========================================================================
-void pulse_compression(stream_in_t &adc_input, stream_out_t &pc_output) {
+void pulse_compression(stream_in_t &adc_input, stream_out_t &pc_output, stream_meta_t &meta_out) {
     #pragma HLS INTERFACE axis port=adc_input
     #pragma HLS INTERFACE axis port=pc_output
+    #pragma HLS INTERFACE axis port=meta_out
     #pragma HLS INTERFACE ap_ctrl_hs port=return
     #pragma HLS DATAFLOW
 
-    static hls::stream<complex_t> s_in_c;
-    static hls::stream<complex_t> s_out_c;
+    static stream_dp_t s_in_c;
+    static stream_dp_t s_out_c;
     #pragma HLS STREAM variable=s_in_c depth=128
     #pragma HLS STREAM variable=s_out_c depth=128
 
-    input_adaptor(adc_input, s_in_c);
-    processing_core(s_in_c, s_out_c);
-    output_adaptor(s_out_c, pc_output);
+    input_adaptor(adc_input, s_in_c, meta_out, 1, true);
+    processing_core(s_in_c, s_out_c, 1);
+    output_adaptor(s_out_c, pc_output, 1);
+}
+
+// 连续模式：整个 CPI (n_pulse 个脉冲，1..N_PULSE) 一次进入 Dataflow 区域
+// 脉冲间隔 = N_RANGE 个周期，FFT/IFFT 延迟只在 CPI 开头付一次
+// tlast_per_pulse：输入 TLAST 约定 (独立使用时逐脉冲，radar_top_pc 按 ctrl.tlast_pulse)
+void pulse_compression_cpi(stream_in_t &adc_input, stream_out_t &pc_output, stream_meta_t &meta_out,
+                           int n_pulse, bool tlast_per_pulse) {
+    #pragma HLS INTERFACE axis port=adc_input
+    #pragma HLS INTERFACE axis port=pc_output
+    #pragma HLS INTERFACE axis port=meta_out
+    #pragma HLS INTERFACE ap_none port=tlast_per_pulse
+    #pragma HLS INTERFACE ap_ctrl_hs port=return
+    #pragma HLS DATAFLOW
+
+    static stream_dp_t s_in_c;
+    static stream_dp_t s_out_c;
+    #pragma HLS STREAM variable=s_in_c depth=128
+    #pragma HLS STREAM variable=s_out_c depth=128
+
+    input_adaptor(adc_input, s_in_c, meta_out, n_pulse, tlast_per_pulse);
+    processing_core(s_in_c, s_out_c, n_pulse);
+    output_adaptor(s_out_c, pc_output, n_pulse);
+}
+
+// 内部形式：不经 output_adaptor，数据通路类型直接交给下游 (radar_top Phase 1 的预积累)
+// n_taps > 0 (radar_ctrl_t.pc_fir_taps) 时走短码 FIR
+void pulse_compression_cpi_dp(stream_in_t &adc_input, stream_dp_t &pc_output, stream_meta_t &meta_out,
+                              int n_pulse, const pc_fir_tap_t taps[PC_FIR_MAX_TAPS], int n_taps,
+                              bool tlast_per_pulse) {
+    #pragma HLS INLINE off
+    #pragma HLS DATAFLOW
+
+    stream_dp_t s_in_c;
+    #pragma HLS STREAM variable=s_in_c depth=128
+
+    input_adaptor(adc_input, s_in_c, meta_out, n_pulse, tlast_per_pulse);
+    pc_core(s_in_c, pc_output, taps, n_taps, n_pulse);
+}
+
+// 短码时域匹配滤波：输入 / 输出适配与 pulse_compression_cpi 共用，核心换成 fir_core
+// taps 为 BRAM 口，主机在 CPI 之间改写 (每次调用开始时载入)
+void pulse_compression_fir(stream_in_t &adc_input, stream_out_t &pc_output, stream_meta_t &meta_out,
+                           const pc_fir_tap_t taps[PC_FIR_MAX_TAPS], int n_taps, int n_pulse) {
+    #pragma HLS INTERFACE axis port=adc_input
+    #pragma HLS INTERFACE axis port=pc_output
+    #pragma HLS INTERFACE axis port=meta_out
+    #pragma HLS INTERFACE bram port=taps
+    #pragma HLS INTERFACE ap_none port=n_taps
+    #pragma HLS INTERFACE ap_ctrl_hs port=return
+    #pragma HLS DATAFLOW
+
+    stream_dp_t s_in_c, s_out_c;
+    #pragma HLS STREAM variable=s_in_c depth=128
+    #pragma HLS STREAM variable=s_out_c depth=16
+
+    input_adaptor(adc_input, s_in_c, meta_out, n_pulse, true);
+    fir_core(s_in_c, s_out_c, taps, n_taps, n_pulse);
+    output_adaptor(s_out_c, pc_output, n_pulse);
+}
+
+// ==========================================================================
+// 5. 共享 FFT 核 (radar_top，RADAR_SHARED_FFT) 的逐脉冲步骤
+// 变换由 radar_top 的共享核完成，这里只有输入转换与频域相乘，运算与 processing_core 相同
+// ==========================================================================
+void pc_shared_load(stream_in_t &adc_input, dp_complex_t x[N_RANGE], pulse_meta_t &meta,
+                    rx_sync_t &sync, bool last_pulse) {
+    #pragma HLS INLINE off
+    Sh_In_Loop: for (int i = 0; i < N_RANGE; i++) {
+        #pragma HLS PIPELINE II=1
+        axis_in_t pkt = rx_sync_beat(adc_input, sync, i);
+        if (i == 0) meta = pulse_meta_unpack(pkt.user);
+        x[i] = adc_unpack(pkt);
+    }
+    meta.rx_err = rx_sync_end(adc_input, sync, last_pulse);
+}
+
+void pc_shared_match(const dp_complex_t y[N_RANGE], dp_complex_t x[N_RANGE]) {
+    #pragma HLS INLINE off
+    Sh_Mf_Loop: for (int i = 0; i < N_RANGE; i++) {
+        #pragma HLS PIPELINE II=1
+        x[i] = y[i] * REF_COEFFS[i];
+    }
 }
@@ -0,0 +1,203 @@
+#ifndef RADAR_COEFFS_GEN_H
+#define RADAR_COEFFS_GEN_H
+
+#include <cstddef>
+#include <utility>
+
+// ==========================================
+// 编译期匹配滤波系数生成 (需 -std=c++14)
+// 与 gen_data_2d.py 相同的算法：
+//   lfm[n]  = exp(j*pi*K*t^2),  t = n/fs,  K = bw / (N/fs)
+//   coef[k] = conj(FFT(lfm))[k] / max|FFT(lfm)|
+// 全部在 constexpr 中完成，N 与 N_RANGE 始终一致，不再需要 Python 生成头文件
+// ==========================================
+namespace coeff_gen {
+
+constexpr double PI = 3.14159265358979323846;
+
+// 角度归约到 [-pi, pi]
+constexpr double wrap_pi(double x) {
+    double n = x / (2.0 * PI);
+    long long k = (long long)(n >= 0 ? n + 0.5 : n - 0.5);
+    return x - 2.0 * PI * (double)k;
+}
+
+// Taylor 级数 (归约到 [-pi/2, pi/2] 后误差 < 1e-15)
+constexpr double sin_taylor(double x) {
+    double term = x, sum = x;
+    for (int i = 1; i < 15; i++) {
+        term *= -x * x / ((2.0 * i) * (2.0 * i + 1.0));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double sin(double x) {
+    x = wrap_pi(x);
+    if (x > PI / 2) x = PI - x;
+    if (x < -PI / 2) x = -PI - x;
+    return sin_taylor(x);
+}
+
+constexpr double cos(double x) {
+    return sin(x + PI / 2);
+}
+
+constexpr double sqrt(double x) {
+    if (x <= 0) return 0.0;
+    double y = x > 1.0 ? x : 1.0;
+    for (int i = 0; i < 64; i++) y = 0.5 * (y + x / y);
+    return y;
+}
+
+template <int N>
+struct table_t {
+    double re[N];
+    double im[N];
+};
+
+// 原位 radix-2 FFT (正变换)
+template <int N>
+constexpr void fft(table_t<N> &x) {
+    static_assert((N & (N - 1)) == 0, "N must be a power of 2");
+    // 位反序
+    for (int i = 1, j = 0; i < N; i++) {
+        int bit = N >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            double tr = x.re[i], ti = x.im[i];
+            x.re[i] = x.re[j]; x.im[i] = x.im[j];
+            x.re[j] = tr;      x.im[j] = ti;
+        }
+    }
+    // 旋转因子只算一次
+    table_t<N> w{};
+    for (int k = 0; k < N / 2; k++) {
+        w.re[k] = cos(-2.0 * PI * k / N);
+        w.im[k] = sin(-2.0 * PI * k / N);
+    }
+    for (int len = 2; len <= N; len <<= 1) {
+        int step = N / len;
+        for (int i = 0; i < N; i += len) {
+            for (int k = 0; k < len / 2; k++) {
+                double wr = w.re[k * step], wi = w.im[k * step];
+                int a = i + k, b = i + k + len / 2;
+                double vr = x.re[b] * wr - x.im[b] * wi;
+                double vi = x.re[b] * wi + x.im[b] * wr;
+                x.re[b] = x.re[a] - vr; x.im[b] = x.im[a] - vi;
+                x.re[a] += vr;          x.im[a] += vi;
+            }
+        }
+    }
+}
+
+// LFM 复制品 -> 共轭频谱 -> 按最大幅度归一化
+template <int N>
+constexpr table_t<N> make_mf_table(double fs, double bw) {
+    table_t<N> x{};
+    double k = bw / (N / fs);
+    for (int n = 0; n < N; n++) {
+        double t = n / fs;
+        double ph = PI * k * t * t;
+        x.re[n] = cos(ph);
+        x.im[n] = sin(ph);
+    }
+    fft<N>(x);
+    double max_mag = 0.0;
+    for (int n = 0; n < N; n++) {
+        double m = sqrt(x.re[n] * x.re[n] + x.im[n] * x.im[n]);
+        if (m > max_mag) max_mag = m;
+    }
+    for (int n = 0; n < N; n++) {
+        x.re[n] = x.re[n] / max_mag;
+        x.im[n] = -x.im[n] / max_mag;
+    }
+    return x;
+}
+
+// 滑动 DFT 旋转因子：W[k] = r * exp(+j*2*pi*k/N)，r < 1 为阻尼因子
+template <int N>
+constexpr table_t<N> make_sdft_twiddle(double r) {
+    table_t<N> w{};
+    for (int k = 0; k < N; k++) {
+        w.re[k] = r * cos(2.0 * PI * k / N);
+        w.im[k] = r * sin(2.0 * PI * k / N);
+    }
+    return w;
+}
+
+constexpr double pow_int(double x, int n) {
+    double y = 1.0;
+    for (int i = 0; i < n; i++) y *= x;
+    return y;
+}
+
+// CIC 幅频响应 |sin(pi*f) / (R*sin(pi*f/R))|^order，f 以 CIC 输出率归一化
+constexpr double cic_response(double f, int r, int order) {
+    if (r <= 1 || f == 0.0) return 1.0;
+    double h = sin(PI * f) / (r * sin(PI * f / r));
+    return pow_int(h < 0.0 ? -h : h, order);
+}
+
+// CIC 补偿 FIR 组 (下变频 2 倍抽取用，实系数放在 re 中)
+// 第 r-1 行 (r = 1..R_MAX) 为 TAPS 个系数：频率采样 + Hamming 窗
+//   期望响应 D(f) = 1/H_cic(f)     |f| <= fp
+//                   线性降到 0      fp < |f| < fs
+// 直流增益归一化为 1
+template <int R_MAX, int TAPS>
+constexpr table_t<R_MAX * TAPS> make_ddc_fir_bank(int order, double fp, double fs) {
+    table_t<R_MAX * TAPS> h{};
+    const int K = 256;   // [0, 0.5] 内的频率采样点数
+    const int M = (TAPS - 1) / 2;
+    for (int r = 1; r <= R_MAX; r++) {
+        double d[K] = {};
+        for (int k = 0; k < K; k++) {
+            double f = (k + 0.5) / (2.0 * K);
+            double g = f <= fp ? 1.0 : (f < fs ? (fs - f) / (fs - fp) : 0.0);
+            double edge = f <= fp ? f : fp;
+            d[k] = g / cic_response(edge, r, order);
+        }
+        double sum = 0.0;
+        for (int n = 0; n <= M; n++) {
+            double acc = 0.0;
+            for (int k = 0; k < K; k++) {
+                double f = (k + 0.5) / (2.0 * K);
+                acc += d[k] * cos(2.0 * PI * f * (n - M));
+            }
+            double w = 0.54 - 0.46 * cos(2.0 * PI * n / (TAPS - 1));
+            double c = acc / K * w;
+            h.re[(r - 1) * TAPS + n] = c;
+            h.re[(r - 1) * TAPS + TAPS - 1 - n] = c;
+            sum += (n == M) ? c : 2.0 * c;
+        }
+        for (int n = 0; n < TAPS; n++) h.re[(r - 1) * TAPS + n] /= sum;
+    }
+    return h;
+}
+
+// 展开成 ROM 初始化列表 (供 static const 数组使用)
+template <class T, int N, const table_t<N> &TAB, class SEQ> struct rom;
+template <class T, int N, const table_t<N> &TAB, std::size_t... I>
+struct rom<T, N, TAB, std::index_sequence<I...>> {
+    static const T table[N];
+};
+template <class T, int N, const table_t<N> &TAB, std::size_t... I>
+const T rom<T, N, TAB, std::index_sequence<I...>>::table[N] = { T(TAB.re[I], TAB.im[I])... };
+
+// 实系数 ROM (只取 re)
+template <class T, int N, const table_t<N> &TAB, class SEQ> struct rom_re;
+template <class T, int N, const table_t<N> &TAB, std::size_t... I>
+struct rom_re<T, N, TAB, std::index_sequence<I...>> {
+    static const T table[N];
+};
+template <class T, int N, const table_t<N> &TAB, std::size_t... I>
+const T rom_re<T, N, TAB, std::index_sequence<I...>>::table[N] = { T(TAB.re[I])... };
+
+} // namespace coeff_gen
+
+// 当前系统参数对应的系数表 (双精度)
+static constexpr coeff_gen::table_t<N_RANGE> RADAR_MF_TABLE =
+    coeff_gen::make_mf_table<N_RANGE>(LFM_FS, LFM_BW);
+
+#endif
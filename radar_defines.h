@@ -6,12 +6,146 @@
 #include <ap_int.h>
 #include <complex>
 #include <hls_fft.h>
+#include "radar_params.h"
 
 // ==========================================
-// 1. 系统参数
+// 1. 系统参数 (尺寸与 LFM 波形参数见 radar_params.h)
 // ==========================================
-#define N_RANGE 128
-#define N_PULSE 128
+// 匹配滤波系数默认由 radar_coeffs_gen.h 在编译期生成
+// 需要沿用 Python 生成的 radar_coeffs.h 时打开此宏
+//#define RADAR_COEFFS_FROM_FILE
+
+// FFT 缩放调度 (每个 radix-4 级 2bit，从低位起)
+// 0x6A: 2+2+2+1 = 7 -> 1/128 ; 0x55: 1+1+1+1 = 4 -> 1/16
+#define PC_FFT_SCH   0x6A
+#define PC_IFFT_SCH  0x55
+#define DOP_FFT_SCH  0x1555
+
+// 单目标多普勒频率估计 (doppler_est_top 的标量输出版本)
+#define DOP_EST_LOG2N  10                    // FFT 长度 2^10 = 1024 (支持 3..16)
+#define DOP_EST_NFFT   (1 << DOP_EST_LOG2N)
+#define DOP_EST_FS     1000000.0f            // 慢时间采样率 (Hz)
+#define DOP_EST_SCH    fft_full_sch(DOP_EST_LOG2N) // 全缩放 (1024 点为 0x2AA)，防止溢出
+#define DOP_EST_INTERP 2                     // 0: 不插值  1: 幅度抛物线  2: Jacobsen
+
+// 软件后端 (CPU 浮点实现 radar_top)，编译时加 -DRADAR_BACKEND_SW 启用
+//#define RADAR_BACKEND_SW
+
+// C-sim FFT 模型 (radar_fft.h，只影响仿真，综合时始终为 hls::fft)
+// RADAR_FAST_FFT   : 用原生定点 FFT 代替 hls::fft 位精确模型，加快长时间仿真
+// RADAR_FFT_XCHECK : 两种实现同时运行并逐帧比较 (输出仍取 hls::fft)
+//#define RADAR_FAST_FFT
+//#define RADAR_FFT_XCHECK
+
+// 输出打包：每个 AXI beat 携带的 RD 单元数 (1 / 2 / 4)
+// DMA 为 128 bit 时设为 4，同一时钟下输出带宽提高 4 倍
+#define OUT_CELLS_PER_BEAT 1
+
+// 帧头：radar_top 在每帧 RD 数据前输出 FRAME_HDR_WORDS 个 32bit 字 (同一 TLAST 包内)
+// 内容为帧计数、尺寸、以及 CPI 内每个脉冲的 TUSER 元数据，主机可直接按帧 DMA
+#define FRAME_HDR_MAGIC   0x52444846   // "RDHF"
+#define FRAME_HDR_VERSION 2
+#define FRAME_HDR_FIXED   12
+#define FRAME_HDR_WORDS   (FRAME_HDR_FIXED + 2 * N_PULSE)
+
+// 角转换矩阵压缩存储 (每脉冲块浮点：共享指数 + CT_MANT_BITS 位尾数)
+// 12 位尾数、每字 3 个单元 -> 72 bit 字，对应 BRAM 512x72 模式
+// 每行 43 字 x 72 bit = 3096 bit，对 128 x 32 bit 按位只省 24.4% (128 不是 3 的倍数，末字只装 2 个单元)，
+// 按 BRAM36 块数计 16 -> 11。11 位尾数按位省 30.7%，9 位尾数每字 4 个单元省 43.75%，SNR 代价见 tb_precision_sweep
+//#define CT_COMPRESS
+#define CT_MANT_BITS 12
+#define CT_PACK      3
+
+// 浮点数据通路 (高动态范围型号)：脉压、角转换存储、多普勒 FFT 改用单精度 hls::fft (不缩放)
+// 强弱回波共存时不再因固定缩放调度截掉弱信号或让强信号溢出，代价是 DSP / BRAM 约翻倍
+// 对外接口不变：ADC 输入、16 位输出、TUSER、帧头；只在输出端乘 2^-shift 换回 16 位 (超出 [-1,1) 饱和)
+//   脉压输出与定点版本同一刻度 (PC_FFT_SCH + PC_IFFT_SCH)
+//   RD 图按 1/N_PULSE 归一 (定点版本 DOP_FFT_SCH 只缩放 1/16，全相干目标会回绕)，比定点版本小 8 倍
+// 与 CT_COMPRESS 互斥
+//#define RADAR_FLOAT_DATAPATH
+
+// 共享 FFT 核 (资源优先型号)：radar_top 的距离 FFT、距离 IFFT 与多普勒 FFT 分时使用同一个 hls::fft 实例
+// 三种变换点数相同 (N_RANGE = N_PULSE)，方向与缩放调度 (PC_FFT_SCH / PC_IFFT_SCH / DOP_FFT_SCH) 随配置字逐帧给出，
+// 结果与独立 FFT 核逐位相同；省下两个 FFT 核的 DSP / BRAM (及两组 FFT 输入输出 FIFO)
+// 代价是变换串行：每个输入脉冲两帧、每个距离门一帧，每帧约 3*N_RANGE + FFT 延迟个周期
+// (读入 / 变换 / 写出不重叠)，CPI 时间约为流式版本的 6~10 倍，适合 PRF 低、通道多的部署
+// 只作用于 radar_top (radar_top_det / radar_top_tap 仍用独立 FFT 核)；与 CT_COMPRESS 互斥
+//#define RADAR_SHARED_FFT
+
+// 滑动 DFT 多普勒 (sdft_doppler.cpp)：每来一个脉冲就更新一次选定 bin 的频谱，延迟一个脉冲
+// SDFT_MAX_BINS   : 并行更新的 bin 数上限 (每个 bin 4 个乘法器，设为 N_PULSE 即全部 bin)
+// SDFT_DAMP_SHIFT : 阻尼 r = 1 - 2^-SHIFT，使定点递推的极点严格落在单位圆内
+//                   等效窗口权重 r^(N_PULSE-m)，12 时最老脉冲约衰减 0.27 dB
+// SDFT_OUT_SHIFT  : 输出右移位数，7 = 1/N_PULSE (与全缩放多普勒 FFT 同一尺度，不会溢出)
+#define SDFT_MAX_BINS   8
+#define SDFT_DAMP_SHIFT 12
+#define SDFT_OUT_SHIFT  7
+
+// 数字下变频前端 (ddc.cpp)：实中频 ADC 样点 -> NCO 混频 -> CIC 抽取 R -> 补偿 FIR 2 倍抽取
+// 总抽取率 2*R，R 运行时由 ddc_ctrl_t.cic_r 给出 (1..DDC_CIC_MAX_R，R=2..4 即 4..8 倍)
+// DDC_CIC_ORDER    : CIC 级数 (差分延迟 M=1)
+// DDC_CIC_GROWTH   : CIC 位增长 = DDC_CIC_ORDER * ceil(log2(DDC_CIC_MAX_R))
+// DDC_FIR_TAPS     : 补偿 FIR 抽头数 (奇数，对称)，按 CIC 输出率工作，每个 R 一组系数
+// DDC_NCO_LUT_BITS : NCO 正弦表地址位宽 (相位截断杂散约 -6 dB/bit)
+#define DDC_CIC_ORDER    3
+#define DDC_CIC_MAX_R    4
+#define DDC_CIC_GROWTH   6
+#define DDC_FIR_TAPS     47
+#define DDC_NCO_LUT_BITS 10
+
+// 短码时域匹配滤波 (pulse_compression_fir)：13~64 码片的相位编码不走 FFT / 相乘 / IFFT，
+// 改用复数 FIR 直接做相关，抽头由主机经 BRAM 口在 CPI 之间写入；输入 / 输出格式与 pulse_compression_cpi 相同
+// radar_top / radar_top_det / radar_top_tap 的 Phase 1 由 radar_ctrl_t.pc_fir_taps 逐 CPI 选择同一个 FIR 核，
+// 抽头从顶层的 pc_fir_tap 数组口读入 (与 dop_win 一样是 BRAM 口，不占 ctrl 寄存器)
+// (两种脉压核都综合，FIR 多占 PC_FIR_MAX_TAPS 个复数乘法器)；RADAR_SHARED_FFT 与 radar_top_pc 只有 FFT 匹配滤波，
+// radar_top_pc 没有抽头口，RADAR_SHARED_FFT 下 radar_top 的抽头口保留但不读
+// PC_FIR_MAX_TAPS : 抽头数上限，每个抽头一个复数乘法器 (全并行，II=1)
+// PC_FIR_SHIFT    : 输出右移位数 = log2(PC_FIR_MAX_TAPS)，满幅输入、全部抽头幅度为 1 时不溢出
+#define PC_FIR_MAX_TAPS 64
+#define PC_FIR_SHIFT    6
+
+// 相参预积累 (高 PRF 模式)：脉压后、存入角转换矩阵前，相邻 K = 2^presum_log2 个脉冲相参平均为一行
+// K 由 radar_ctrl_t.presum_log2 运行时给出 (0 关闭)，输入脉冲数 = n_pulse * K，矩阵与 Phase 2 仍按 n_pulse 行
+// 可选脉间相位补偿 presum_fcw：先把关心的多普勒带搬到零频，再做 K 点矩形积累 (慢时间低通 + 抽取)
+// PRESUM_MAX_LOG2     : K 上限 2^3 = 8
+// PRESUM_NCO_LUT_BITS : 相位补偿正弦表地址位宽
+#define PRESUM_MAX_LOG2     3
+#define PRESUM_MAX_PULSES   (N_PULSE << PRESUM_MAX_LOG2)
+#define PRESUM_NCO_LUT_BITS 10
+
+// 多普勒子带：radar_ctrl_t.dop_first / dop_bins 选定连续的一段输出 bin，每个距离门只输出这些 bin
+// 只有 dop_bins <= DOP_BAND_MAX_BINS 且距离优先时才是真正的子带处理：不做多普勒 FFT，改用 DFT 组：
+//   逐行读矩阵 (只读前 n_pulse 行)，每脉冲每 bin 一次复数乘，DOP_BAND_MAX_BINS 个 bin 并行
+//   (乘法器按 DOP_BAND_MAX_BINS 综合，与运行时 dop_bins 无关)；Phase 2 仍受读矩阵限制，
+//   约 n_pulse * N_RANGE 个周期，省的是 FFT 核与短 CPI 的补零部分
+// 更宽的子带 (及多普勒优先输出) 只是输出裁剪：完整 FFT 照做，计算量与周期数与全图相同，
+// 只减少输出单元数 (N_RANGE * dop_bins)；没有 zoom / 剪枝 FFT 路径
+#define DOP_BAND_MAX_BINS 8
+
+// 距离像旁路输出 (radar_top_tap)：脉压结果在进入预积累 / 角转换存储之前分叉，
+// 每个输入脉冲脉压完成即从 tap_output 输出一个 TLAST 包，元数据从 meta_out 输出，不等整个 CPI
+// 由 tap_ctrl_t 选择复数 / |X|^2，以及 2^decim_log2 个距离门抽取为一个
+// TAP_MAX_DECIM_LOG2 : 抽取上限 2^4 = 16 (每脉冲至少 N_RANGE/16 个单元)
+#define TAP_MAX_DECIM_LOG2 4
+// TAP_FIFO_PULSES : 分叉与打包之间缓冲的脉冲数 (含打包任务正在输出的一个)
+// 每个脉冲开始时分叉检查能否再放下整个脉冲，放不下则整个脉冲不旁路 (帧头字 10 计数)，
+// 旁路下游再慢也不会反压脉压与角转换存储
+#define TAP_FIFO_PULSES 2
+
+// 检测级 (radar_top_det)：距离向单元平均 CFAR，每个多普勒通道独立
+// CFAR_GUARD / CFAR_TRAIN : 被测单元每侧的保护 / 参考单元数 (距离门)
+// CFAR_MAX_DET            : 每帧最多输出的检测数，超出部分只计数
+#define CFAR_GUARD   2
+#define CFAR_TRAIN   8
+#define CFAR_MAX_DET 256
+#define DET_TRAILER_MAGIC 0x44455431   // "DET1"
+
+#if defined(RADAR_FLOAT_DATAPATH) && defined(CT_COMPRESS)
+#error "CT_COMPRESS stores block-floating-point mantissas of the fixed-point datapath"
+#endif
+#if defined(RADAR_SHARED_FFT) && defined(CT_COMPRESS)
+#error "RADAR_SHARED_FFT writes uncompressed rows and columns back to the corner-turn matrix"
+#endif
 
 // ==========================================
 // 2. 类型定义
@@ -37,6 +171,31 @@ typedef ap_fixed<16, 1, AP_RND, AP_SAT> coeff_t;
 // 为避免类型转换麻烦，系数最好也统一，或者在乘法时强转
 typedef std::complex<fft_data_t> complex_coeff_t;
 
+// D. 数据通路 (脉压 -> 角转换 -> 多普勒 FFT) 的样点类型
+// 定点版本即 fft_data_t；RADAR_FLOAT_DATAPATH 时为 float，只在输出端换回 16 位
+#ifdef RADAR_FLOAT_DATAPATH
+typedef float dp_data_t;
+#else
+typedef fft_data_t dp_data_t;
+#endif
+typedef std::complex<dp_data_t> dp_complex_t;
+
+inline dp_data_t dp_from_fixed(fft_data_t x) {
+#ifdef RADAR_FLOAT_DATAPATH
+    return x.to_float();
+#else
+    return x;
+#endif
+}
+
+inline float dp_to_float(dp_data_t x) {
+#ifdef RADAR_FLOAT_DATAPATH
+    return x;
+#else
+    return x.to_float();
+#endif
+}
+
 
 // 复数结构体 (用于结构体流)
 struct my_complex_t {
@@ -44,49 +203,313 @@ struct my_complex_t {
     fft_data_t im;
 };
 
+// FFT 数据格式 (三个配置共用)
+// 浮点 IP：32 位单精度、旋转因子 24 位、不缩放 (配置字只有方向位)
+#ifdef RADAR_FLOAT_DATAPATH
+#define RADAR_FFT_DATA_W  32
+#define RADAR_FFT_PF_W    24
+#define RADAR_FFT_CFG_W   8
+#define RADAR_FFT_SCALING hls::ip_fft::unscaled
+#else
+#define RADAR_FFT_DATA_W  16
+#define RADAR_FFT_PF_W    16
+#define RADAR_FFT_CFG_W   16
+#define RADAR_FFT_SCALING hls::ip_fft::scaled
+#endif
+
 // (A) 脉冲压缩用的 FFT 配置 (1024点)
 struct fft_config : hls::ip_fft::params_t {
-    static const unsigned input_width  = 16;
-    static const unsigned output_width = 16;
+    static const unsigned input_width  = RADAR_FFT_DATA_W;
+    static const unsigned output_width = RADAR_FFT_DATA_W;
+    static const unsigned phase_factor_width = RADAR_FFT_PF_W;
     static const unsigned max_nfft = 7;
     static const unsigned nfft = 128;
     static const bool     has_nfft = false;
-    static const unsigned config_width = 16;
+    static const unsigned config_width = RADAR_FFT_CFG_W;
     static const unsigned status_width = 8;
     static const unsigned ordering_opt = hls::ip_fft::natural_order;
     static const unsigned arch_opt = hls::ip_fft::pipelined_streaming_io;
     static const unsigned round_opt = hls::ip_fft::truncation;
-    static const unsigned scaling_opt = hls::ip_fft::scaled;
+    static const unsigned scaling_opt = RADAR_FFT_SCALING;
 };
 
 // (B) 多普勒用的 FFT 配置 (128点)
 struct doppler_fft_config : hls::ip_fft::params_t {
-    static const unsigned input_width  = 16;
-    static const unsigned output_width = 16;
+    static const unsigned input_width  = RADAR_FFT_DATA_W;
+    static const unsigned output_width = RADAR_FFT_DATA_W;
+    static const unsigned phase_factor_width = RADAR_FFT_PF_W;
     static const unsigned max_nfft = 7; // 2^7 = 128
     static const unsigned nfft = 128; //
 
    // static const unsigned max_nfft = 7; // 2^7 = 128
    //static const unsigned nfft = 7; //
     static const bool     has_nfft = false;
-    static const unsigned config_width = 16;
+    static const unsigned config_width = RADAR_FFT_CFG_W;
    //static const unsigned config_width = 16;
     static const unsigned status_width = 8;
     static const unsigned ordering_opt = hls::ip_fft::natural_order;
     static const unsigned arch_opt = hls::ip_fft::pipelined_streaming_io;
     static const unsigned round_opt = hls::ip_fft::truncation;
-    static const unsigned scaling_opt = hls::ip_fft::scaled;
+    static const unsigned scaling_opt = RADAR_FFT_SCALING;
+};
+
+// 由缩放调度算出总右移位数 (只统计 ceil(log2n/2) 个有效级)
+constexpr int fft_sch_shift(unsigned sch, int log2n) {
+    int shift = 0;
+    for (int s = 0; s < (log2n + 1) / 2; s++) {
+        shift += (sch >> (2 * s)) & 3;
+    }
+    return shift;
+}
+
+// 全缩放调度：每个 radix-4 级右移 2 位，级数为奇数时最后的 radix-2 级右移 1 位
+// 例：log2n=7 -> 0x6A，log2n=10 -> 0x2AA
+constexpr unsigned fft_full_sch(int log2n) {
+    return log2n <= 0 ? 0u : (log2n == 1 ? 1u : ((fft_full_sch(log2n - 2) << 2) | 2u));
+}
+
+// (C) 频率估计用的 FFT 配置 (长度由 DOP_EST_LOG2N 决定)
+struct doppler_est_fft_config : hls::ip_fft::params_t {
+    static const unsigned input_width  = RADAR_FFT_DATA_W;
+    static const unsigned output_width = RADAR_FFT_DATA_W;
+    static const unsigned phase_factor_width = RADAR_FFT_PF_W;
+    static const unsigned max_nfft = DOP_EST_LOG2N;
+    static const unsigned nfft = DOP_EST_NFFT;
+    static const bool     has_nfft = false;
+    static const unsigned config_width = RADAR_FFT_CFG_W;
+    static const unsigned status_width = 8;
+    static const unsigned ordering_opt = hls::ip_fft::natural_order;
+    static const unsigned arch_opt = hls::ip_fft::pipelined_streaming_io;
+    static const unsigned round_opt = hls::ip_fft::truncation;
+    static const unsigned scaling_opt = RADAR_FFT_SCALING;
+};
+
+// 各输出口相对数据通路输入的总右移位数 (定点版本在 FFT 内完成，浮点版本在输出端一次补上)
+// PC_DP_SHIFT : 脉压输出 (radar_top_pc / pulse_compression)
+// RD_DP_SHIFT : RD 图输出 (radar_top)，软件后端按同一刻度
+static const int PC_DP_SHIFT = fft_sch_shift(PC_FFT_SCH, fft_config::max_nfft) +
+                               fft_sch_shift(PC_IFFT_SCH, fft_config::max_nfft);
+#ifdef RADAR_FLOAT_DATAPATH
+static const int RD_DP_SHIFT = PC_DP_SHIFT + doppler_fft_config::max_nfft;
+#else
+static const int RD_DP_SHIFT = PC_DP_SHIFT + fft_sch_shift(DOP_FFT_SCH, doppler_fft_config::max_nfft);
+#endif
+
+// 角转换矩阵存储字
+#ifdef CT_COMPRESS
+typedef ap_fixed<CT_MANT_BITS, 1, AP_RND, AP_SAT> ct_mant_t;
+typedef ap_uint<2 * CT_MANT_BITS * CT_PACK> ct_word_t;
+#define CT_WORDS ((N_RANGE + CT_PACK - 1) / CT_PACK)
+#else
+typedef dp_complex_t ct_word_t;
+#define CT_WORDS N_RANGE
+#endif
+typedef ap_uint<4> ct_exp_t;   // 每脉冲共享指数 (左移位数，0..15)
+
+// 滑动 DFT 状态与旋转因子
+// 累加器整数位覆盖 N_PULSE 个满幅样点之和 (128 * sqrt(2) < 2^8)
+typedef ap_fixed<34, 9> sdft_acc_t;
+typedef ap_fixed<18, 2, AP_RND> sdft_tw_t;
+typedef std::complex<sdft_tw_t> sdft_tw_cplx_t;
+
+// 每个距离门一次输出的 SDFT_MAX_BINS 个 bin
+struct sdft_vec_t {
+    complex_t bin[SDFT_MAX_BINS];
+};
+
+// 慢时间窗系数 (无符号，1.0 可精确表示，全 1 窗与不加窗逐位一致)
+typedef ap_ufixed<16, 1> dop_win_t;
+
+// 下变频数据通路
+typedef ap_fixed<18, 2, AP_RND> ddc_nco_t;                 // NCO 表 (cos / -sin，1.0 可表示)
+typedef ap_fixed<18, 1, AP_TRN, AP_SAT> ddc_data_t;       // 混频 / CIC 归一化后 / FIR 输出
+typedef std::complex<ddc_data_t> ddc_cplx_t;
+typedef ap_fixed<18 + DDC_CIC_GROWTH, 1 + DDC_CIC_GROWTH> ddc_cic_t;  // CIC 积分器 (回绕)
+typedef ap_ufixed<18, 2> ddc_gain_t;                      // CIC 增益归一化 2 / R^N
+typedef ap_fixed<18, 1, AP_RND, AP_SAT> ddc_coef_t;       // 补偿 FIR 系数
+typedef ap_fixed<40, 4> ddc_acc_t;                        // FIR 累加器
+
+// 短码 FIR：抽头 (主机写入的端口格式，1.0 可表示)、运算用系数与累加器 (PC_FIR_MAX_TAPS 个复数乘积之和)
+typedef std::complex<ap_fixed<18, 2, AP_RND> > pc_fir_tap_t;
+#ifdef RADAR_FLOAT_DATAPATH
+typedef float pc_fir_coef_t;
+typedef float pc_fir_acc_t;
+#else
+typedef ap_fixed<18, 2, AP_RND> pc_fir_coef_t;
+typedef ap_fixed<42, 10> pc_fir_acc_t;
+#endif
+
+// 相参预积累：部分和 (K 个脉冲、旋转后分量可达 sqrt(2)) 与相位补偿表
+#ifdef RADAR_FLOAT_DATAPATH
+typedef float presum_acc_t;
+typedef float presum_nco_t;
+#else
+typedef ap_fixed<16 + PRESUM_MAX_LOG2 + 1, 2 + PRESUM_MAX_LOG2> presum_acc_t;
+typedef ap_fixed<18, 2, AP_RND> presum_nco_t;             // cos / sin，1.0 可表示
+#endif
+
+// 多普勒子带 DFT 组：旋转因子 (1.0 可表示) 与累加器 (N_PULSE 个乘积，未缩放)
+#ifdef RADAR_FLOAT_DATAPATH
+typedef float dop_band_tw_t;
+typedef float dop_band_acc_t;
+#else
+typedef ap_fixed<18, 2, AP_RND> dop_band_tw_t;
+typedef ap_fixed<42, 10> dop_band_acc_t;
+#endif
+
+// 功率 |X|^2 (分量在 [-1,1) 内，最大不超过 2)
+typedef ap_ufixed<32, 2> dop_pow_t;
+
+// 峰值搜索结果：峰值 bin 及左右相邻复数样点
+struct dop_peak_t {
+    ap_uint<DOP_EST_LOG2N> bin;
+    dp_complex_t left;
+    dp_complex_t peak;
+    dp_complex_t right;
 };
 
 // ==========================================
 // 3. 接口结构体
 // ==========================================
+// 脉冲元数据 (TUSER，每个脉冲第一个样点有效)
+// TUSER 位分配：[31:0] 时间戳  [47:32] 脉冲序号  [55:48] 波形编号  [63:56] 通道号
+// rx_err 不在 TUSER 中，由输入端按 TLAST 检查后填入 (见 rx_sync_t)
+#define PULSE_META_W 64
+struct pulse_meta_t {
+    ap_uint<32> timestamp;
+    ap_uint<16> pulse_idx;
+    ap_uint<8>  waveform;
+    ap_uint<8>  channel;
+    ap_uint<2>  rx_err;     // bit0 短包 (已补零)  bit1 长包 (已截断)
+};
+
+inline pulse_meta_t pulse_meta_unpack(ap_uint<PULSE_META_W> user) {
+    pulse_meta_t m;
+    m.timestamp = user.range(31, 0);
+    m.pulse_idx = user.range(47, 32);
+    m.waveform  = user.range(55, 48);
+    m.channel   = user.range(63, 56);
+    m.rx_err    = 0;
+    return m;
+}
+
+inline ap_uint<PULSE_META_W> pulse_meta_pack(const pulse_meta_t &m) {
+    ap_uint<PULSE_META_W> user;
+    user.range(31, 0)  = m.timestamp;
+    user.range(47, 32) = m.pulse_idx;
+    user.range(55, 48) = m.waveform;
+    user.range(63, 56) = m.channel;
+    return user;
+}
+
+// 运行时控制字 (radar_top 的 ctrl 端口)
+struct radar_ctrl_t {
+    ap_uint<1> dop_major;   // 输出顺序 0: 距离优先 r*N_PULSE+d   1: 多普勒优先 d*N_RANGE+r (多一遍整图读出，周期数至少为距离优先的 5 倍)
+    ap_uint<1> dop_shift;   // 1: 多普勒轴 fftshift，第 k 个输出 bin 对应 k - N_PULSE/2
+    ap_uint<16> n_pulse;    // 本 CPI 实际脉冲数 1..N_PULSE (0 视为 N_PULSE)，多普勒 FFT 前在读列时补零
+    ap_uint<1> win_en;      // 1: 读列时乘慢时间窗 dop_win[p]
+    ap_uint<2> presum_log2; // 相参预积累 K = 2^presum_log2 个输入脉冲合为一行 (0: 关闭，只对带多普勒的核有效)
+    ap_uint<16> presum_fcw; // 预积累前第 m 个输入脉冲乘 exp(-j*2*pi*presum_fcw*m/2^16) (0: 不补偿)
+    ap_uint<16> dop_first;  // 多普勒子带首个输出 bin (按 dop_shift 之后的编号，超出 N_PULSE 回绕)
+    ap_uint<16> dop_bins;   // 每个距离门输出的 bin 数 (0 视为 N_PULSE，即全部；检测核忽略；> DOP_BAND_MAX_BINS 只裁剪输出)
+    ap_uint<7> pc_fir_taps; // 脉压方式 0: FFT 匹配滤波 (LFM)  1..PC_FIR_MAX_TAPS: 短码 FIR，用抽头口 pc_fir_tap 前 pc_fir_taps 个
+    ap_uint<1> tlast_pulse; // 输入 TLAST 约定 0: 整次调用只在最后一个样点  1: 每个脉冲末尾 (见 rx_sync_t)
+};
+
+// 有效 CPI 脉冲数 (0 或越界时取 N_PULSE)，预积累时为积累后的行数
+inline int radar_ctrl_pulses(radar_ctrl_t ctrl) {
+    return (ctrl.n_pulse == 0 || ctrl.n_pulse > N_PULSE) ? N_PULSE : (int)ctrl.n_pulse;
+}
+
+// 预积累 log2(K) 与输入端脉冲数
+inline int radar_ctrl_presum(radar_ctrl_t ctrl) {
+    return ctrl.presum_log2 > PRESUM_MAX_LOG2 ? PRESUM_MAX_LOG2 : (int)ctrl.presum_log2;
+}
+inline int radar_ctrl_in_pulses(radar_ctrl_t ctrl) {
+    return radar_ctrl_pulses(ctrl) << radar_ctrl_presum(ctrl);
+}
+
+// 短码 FIR 抽头数 (0 为 FFT 匹配滤波，超过上限时按 PC_FIR_MAX_TAPS)
+inline int radar_ctrl_pc_fir(radar_ctrl_t ctrl) {
+    return ctrl.pc_fir_taps > PC_FIR_MAX_TAPS ? PC_FIR_MAX_TAPS : (int)ctrl.pc_fir_taps;
+}
+
+// 多普勒子带：输出 bin 数、首个 bin，以及第 j 个输出对应的 FFT bin (已计入 fftshift)
+inline int radar_ctrl_dop_bins(radar_ctrl_t ctrl) {
+    return (ctrl.dop_bins == 0 || ctrl.dop_bins > N_PULSE) ? N_PULSE : (int)ctrl.dop_bins;
+}
+inline int radar_ctrl_dop_first(radar_ctrl_t ctrl) {
+    return ctrl.dop_first % N_PULSE;
+}
+inline int radar_ctrl_fft_bin(radar_ctrl_t ctrl, int j) {
+    int d = (radar_ctrl_dop_first(ctrl) + j) % N_PULSE;
+    return ctrl.dop_shift ? (d ^ (N_PULSE / 2)) : d;
+}
+
+// 滑动 DFT 控制 (radar_sdft_top 的 ctrl 端口)
+// 更换 bin 列表时应同时置 reset，否则该 bin 的状态仍是旧 bin 的频谱
+struct sdft_ctrl_t {
+    ap_uint<8> n_bins;                // 有效 bin 数 (1..SDFT_MAX_BINS)
+    ap_uint<8> bin[SDFT_MAX_BINS];    // 多普勒 bin 号 (0..N_PULSE-1，与 FFT 自然顺序相同)
+    ap_uint<1> reset;                 // 1: 清空窗口，本脉冲作为窗口内第一个脉冲
+};
+
+// CFAR 控制 (radar_top_det 的 cfar_ctrl 端口)
+// 判决：|X|^2 * n_ref > scale * sum(参考单元 |X|^2)，即超过参考单元均值的 scale 倍
+struct cfar_ctrl_t {
+    ap_ufixed<16, 8> scale;    // 门限因子 (线性功率比)，0 表示关闭检测 (只输出尾字)
+};
+
+// 距离像旁路控制 (radar_top_tap 的 tap_ctrl 端口)
+// mode 1：复数单元，与 radar_top_pc 输出同刻度，抽取时取每组第一个距离门
+// mode 2：|X|^2 (dop_pow_t 位模式)，抽取时取每组最大值 (峰值不因抽取丢失)
+struct tap_ctrl_t {
+    ap_uint<2> mode;          // 0 关闭 (不输出)，1 复数，2 功率，3 保留 (同 0)
+    ap_uint<3> decim_log2;    // 每 2^decim_log2 个距离门输出一个单元，超过 TAP_MAX_DECIM_LOG2 时按上限
+};
+
+inline int tap_ctrl_decim(tap_ctrl_t t) {
+    #pragma HLS INLINE
+    return t.decim_log2 > TAP_MAX_DECIM_LOG2 ? TAP_MAX_DECIM_LOG2 : (int)t.decim_log2;
+}
+
+// 检测输出：每个检测一个 64 bit 字
+//   [15:0] 距离门  [31:16] 多普勒 bin (与 RD 输出同序，dop_shift 时为移位后序号)  [63:32] |X|^2 (dop_pow_t 位模式)
+// 最后一个字为尾字 (TLAST=1)：[31:0] DET_TRAILER_MAGIC  [47:32] 输出检测数  [63:48] 丢弃检测数
+struct axis_det_t {
+    ap_uint<64> data;
+    ap_uint<1> last;
+    ap_uint<8> keep;
+    ap_uint<8> strb;
+};
+
+// 下变频控制 (radar_ddc 的 ctrl 端口)
+struct ddc_ctrl_t {
+    ap_uint<32> nco_fcw;    // NCO 频率字 = f_IF / f_ADC * 2^32，混频乘 exp(-j*2*pi*fcw*n/2^32)
+    ap_uint<4>  cic_r;      // CIC 抽取率 1..DDC_CIC_MAX_R (0 或越界时取 DDC_CIC_MAX_R)
+};
+
+inline int ddc_ctrl_r(ddc_ctrl_t ctrl) {
+    return (ctrl.cic_r == 0 || ctrl.cic_r > DDC_CIC_MAX_R) ? DDC_CIC_MAX_R : (int)ctrl.cic_r;
+}
+
+// 实中频输入接口：[13:0] 为 14 位 ADC 补码样点，每个脉冲 N_RANGE * 2 * R 个样点
+// TUSER 只在脉冲第一个样点有效 (与 axis_in_t 相同)，TLAST 标记脉冲最后一个样点
+struct axis_if_t {
+    ap_uint<16> data;
+    ap_uint<1> last;
+    ap_uint<2> keep;
+    ap_uint<2> strb;
+    ap_uint<PULSE_META_W> user;
+};
+
 // 输入接口：保持 ap_uint<32> 以便位操作打包
 struct axis_in_t {
     ap_uint<32> data;
     ap_uint<1> last;
     ap_uint<4> keep;
     ap_uint<4> strb;
+    ap_uint<PULSE_META_W> user;
 };
 
 // 输出接口：使用结构体，方便查看 re/im
@@ -97,25 +520,396 @@ struct axis_out_t {
     ap_uint<4> strb;
 };
 
+// radar_top 输出接口：每 beat OUT_CELLS_PER_BEAT 个单元
+// 第 k 个单元占 data[32k+31 : 32k]，其中低 16 位实部、高 16 位虚部 (与 my_complex_t 打包一致)
+// 列尾不足一个 beat 时 keep/strb 只置有效字节，TLAST 只在整帧最后一个 beat 拉高
+#if OUT_CELLS_PER_BEAT == 1
+typedef axis_out_t axis_rd_t;
+#else
+struct axis_rd_t {
+    ap_uint<32 * OUT_CELLS_PER_BEAT> data;
+    ap_uint<1> last;
+    ap_uint<4 * OUT_CELLS_PER_BEAT> keep;
+    ap_uint<4 * OUT_CELLS_PER_BEAT> strb;
+};
+#endif
+
+// beat 内单元的写入 / 读取 (radar_top、软件后端和 TB 共用)
+// 每 beat 一个单元时 k 恒为 0，不使用
+inline void rd_beat_set_cell(axis_out_t &beat, int, fft_data_t re, fft_data_t im) {
+    beat.data.re = re;
+    beat.data.im = im;
+}
+inline void rd_beat_set_word(axis_out_t &beat, int, ap_uint<32> w) {
+    beat.data.re.range(15, 0) = w.range(15, 0);
+    beat.data.im.range(15, 0) = w.range(31, 16);
+}
+inline ap_uint<32> rd_beat_word(const axis_out_t &beat, int) {
+    ap_uint<32> w;
+    w.range(15, 0) = beat.data.re.range(15, 0);
+    w.range(31, 16) = beat.data.im.range(15, 0);
+    return w;
+}
+inline my_complex_t rd_beat_cell(const axis_out_t &beat, int) {
+    return beat.data;
+}
+inline int rd_beat_cells(const axis_out_t &) {
+    return 1;
+}
+#if OUT_CELLS_PER_BEAT > 1
+inline void rd_beat_set_cell(axis_rd_t &beat, int k, fft_data_t re, fft_data_t im) {
+    if (k == 0) beat.data = 0;   // 新 beat 开始，未用单元补 0
+    beat.data.range(32 * k + 15, 32 * k) = re.range(15, 0);
+    beat.data.range(32 * k + 31, 32 * k + 16) = im.range(15, 0);
+}
+inline void rd_beat_set_word(axis_rd_t &beat, int k, ap_uint<32> w) {
+    if (k == 0) beat.data = 0;
+    beat.data.range(32 * k + 31, 32 * k) = w;
+}
+inline ap_uint<32> rd_beat_word(const axis_rd_t &beat, int k) {
+    return beat.data.range(32 * k + 31, 32 * k);
+}
+inline my_complex_t rd_beat_cell(const axis_rd_t &beat, int k) {
+    my_complex_t c;
+    c.re.range(15, 0) = beat.data.range(32 * k + 15, 32 * k);
+    c.im.range(15, 0) = beat.data.range(32 * k + 31, 32 * k + 16);
+    return c;
+}
+inline int rd_beat_cells(const axis_rd_t &beat) {
+    int n = 0;
+    for (int k = 0; k < OUT_CELLS_PER_BEAT; k++) n += beat.keep[4 * k];
+    return n;
+}
+#endif
+
+// 帧头第 k 个字
+//   0: FRAME_HDR_MAGIC
+//   1: [15:0] 版本  [31:16] 帧头字数
+//   2: 帧计数
+//   3: [15:0] N_RANGE  [31:16] N_PULSE
+//   4: 首脉冲时间戳    5: 末脉冲时间戳
+//   6: [15:0] 首脉冲序号  [23:16] 波形  [31:24] 通道 (取首脉冲)
+//   7: 标志 bit0 = CPI 内波形/通道不一致，bit1 = 脉冲序号不连续
+//           bit2 = 有脉冲短包 (TLAST 提前，已补零)，bit3 = 有脉冲长包 (TLAST 迟到，已截断)
+//           bit4 = 距离像旁路丢弃了脉冲 (radar_top_tap)
+//           bit8 = 多普勒优先输出，bit9 = 多普勒轴已 fftshift，bit10 = 已加慢时间窗
+//           [13:11] = 预积累 log2(K)，[31:16] = 实际脉冲数 (预积累后的行数，其余补零)
+//   8: 多普勒子带 [15:0] 首个输出 bin  [31:16] 每个距离门的输出 bin 数 (全部输出时为 N_PULSE)
+//   9: 输入帧错误 [15:0] 短包行数  [31:16] 长包行数 (预积累时组内任一脉冲出错即计该行)
+//   10: 距离像旁路丢弃的输入脉冲数 (旁路缓冲已满；radar_top_tap 之外恒为 0)
+//   11: 保留 (0)
+//   12 + 2p / 13 + 2p: 第 p 个脉冲 TUSER 的低 / 高 32 位 (p >= 实际脉冲数时为 0)
+//                    预积累时为第 p 组首个输入脉冲，序号连续性按步长 K 检查
+static_assert(FRAME_HDR_WORDS % OUT_CELLS_PER_BEAT == 0, "frame header must fill whole beats");
+#define FRAME_HDR_BEATS (FRAME_HDR_WORDS / OUT_CELLS_PER_BEAT)
+
+inline ap_uint<32> frame_hdr_rx_err(const pulse_meta_t meta[N_PULSE], radar_ctrl_t ctrl) {
+    ap_uint<16> n_short = 0, n_long = 0;
+    int n_pulse = radar_ctrl_pulses(ctrl);
+    for (int p = 0; p < N_PULSE; p++) {
+        if (p >= n_pulse) break;
+        n_short += meta[p].rx_err[0];
+        n_long += meta[p].rx_err[1];
+    }
+    ap_uint<32> w;
+    w.range(15, 0) = n_short;
+    w.range(31, 16) = n_long;
+    return w;
+}
+
+inline ap_uint<32> frame_hdr_flags(const pulse_meta_t meta[N_PULSE], radar_ctrl_t ctrl) {
+    ap_uint<32> flags = 0;
+    int n_pulse = radar_ctrl_pulses(ctrl);
+    ap_uint<32> rx_err = frame_hdr_rx_err(meta, ctrl);
+    flags[2] = rx_err.range(15, 0) != 0;
+    flags[3] = rx_err.range(31, 16) != 0;
+    flags[8] = ctrl.dop_major;
+    flags[9] = ctrl.dop_shift;
+    flags[10] = ctrl.win_en;
+    flags.range(13, 11) = radar_ctrl_presum(ctrl);
+    flags.range(31, 16) = n_pulse;
+    const int step = 1 << radar_ctrl_presum(ctrl);
+    for (int p = 1; p < N_PULSE; p++) {
+        if (p >= n_pulse) break;
+        if (meta[p].waveform != meta[0].waveform || meta[p].channel != meta[0].channel) flags[0] = 1;
+        if (meta[p].pulse_idx != (ap_uint<16>)(meta[p - 1].pulse_idx + step)) flags[1] = 1;
+    }
+    return flags;
+}
+
+inline ap_uint<32> frame_hdr_band(radar_ctrl_t ctrl) {
+    ap_uint<32> band = 0;
+    band.range(15, 0) = radar_ctrl_dop_first(ctrl);
+    band.range(31, 16) = radar_ctrl_dop_bins(ctrl);
+    return band;
+}
+
+inline ap_uint<32> frame_hdr_word(int k, ap_uint<32> frame_cnt, ap_uint<32> flags, ap_uint<32> band,
+                                  ap_uint<32> rx_err, const pulse_meta_t meta[N_PULSE],
+                                  ap_uint<32> tap_drop = 0) {
+    int n_pulse = flags.range(31, 16);
+    ap_uint<32> w = 0;
+    if (k == 0) w = FRAME_HDR_MAGIC;
+    else if (k == 1) { w.range(15, 0) = FRAME_HDR_VERSION; w.range(31, 16) = FRAME_HDR_WORDS; }
+    else if (k == 2) w = frame_cnt;
+    else if (k == 3) { w.range(15, 0) = N_RANGE; w.range(31, 16) = N_PULSE; }
+    else if (k == 4) w = meta[0].timestamp;
+    else if (k == 5) w = meta[n_pulse - 1].timestamp;
+    else if (k == 6) {
+        w.range(15, 0) = meta[0].pulse_idx;
+        w.range(23, 16) = meta[0].waveform;
+        w.range(31, 24) = meta[0].channel;
+    }
+    else if (k == 7) { w = flags; w[4] = tap_drop != 0; }
+    else if (k == 8) w = band;
+    else if (k == 9) w = rx_err;
+    else if (k == 10) w = tap_drop;
+    else if (k < FRAME_HDR_FIXED) w = 0;
+    else if ((k - FRAME_HDR_FIXED) / 2 < n_pulse) {
+        ap_uint<PULSE_META_W> user = pulse_meta_pack(meta[(k - FRAME_HDR_FIXED) / 2]);
+        w = ((k - FRAME_HDR_FIXED) & 1) ? user.range(63, 32) : user.range(31, 0);
+    }
+    return w;
+}
+
 // 流定义
+typedef hls::stream<axis_if_t>  stream_if_t;
 typedef hls::stream<axis_in_t>  stream_in_t;
+typedef hls::stream<axis_det_t> stream_det_t;
 typedef hls::stream<axis_out_t> stream_out_t;
+typedef hls::stream<axis_rd_t>  stream_rd_t;
 typedef hls::stream<complex_t> stream_internal_t;
+typedef hls::stream<dp_complex_t> stream_dp_t;   // 数据通路内部 (定点版本即 stream_internal_t)
 typedef hls::stream<my_complex_t> stream_mid_t;
+typedef hls::stream<pulse_meta_t> stream_meta_t;
+
+// 数据通路 -> 16 位输出，SHIFT 为该输出口的总右移位数 (PC_DP_SHIFT / RD_DP_SHIFT)
+// 浮点版本在这里乘 2^-SHIFT，超出 [-1,1) 饱和；定点版本已在 FFT 内缩放，原样输出
+template <int SHIFT>
+inline complex_t dp_to_fixed(dp_complex_t v) {
+    #pragma HLS INLINE
+#ifdef RADAR_FLOAT_DATAPATH
+    typedef ap_fixed<16, 1, AP_TRN, AP_SAT> sat_t;
+    const float g = 1.0f / (float)(1L << SHIFT);
+    return complex_t((fft_data_t)(sat_t)(v.real() * g), (fft_data_t)(sat_t)(v.imag() * g));
+#else
+    return v;
+#endif
+}
+
+// 单元写入输出 beat，满 beat 或 flush 时发出 (radar_top / sdft_doppler 共用)
+// keep/strb 只置有效单元，last 只在整帧最后一个单元拉高
+// rd_push_word 写入 32 位原始字 (距离像旁路的功率单元)，其余与 rd_push_cell 相同
+inline void rd_push_word(stream_rd_t &output, axis_rd_t &beat, int &slot,
+                         ap_uint<32> w, bool flush, bool last) {
+    #pragma HLS INLINE
+    rd_beat_set_word(beat, slot, w);
+    if (slot == OUT_CELLS_PER_BEAT - 1 || flush) {
+        ap_uint<4 * OUT_CELLS_PER_BEAT> keep = 0;
+        for (int k = 0; k < OUT_CELLS_PER_BEAT; k++) {
+            #pragma HLS UNROLL
+            if (k <= slot) keep.range(4 * k + 3, 4 * k) = 0xF;
+        }
+        beat.last = last;
+        beat.keep = keep;
+        beat.strb = keep;
+        output.write(beat);
+        slot = 0;
+    } else {
+        slot++;
+    }
+}
+
+inline void rd_push_cell(stream_rd_t &output, axis_rd_t &beat, int &slot,
+                         complex_t val, bool flush, bool last) {
+    #pragma HLS INLINE
+    ap_uint<32> w;
+    w.range(15, 0) = val.real().range(15, 0);
+    w.range(31, 16) = val.imag().range(15, 0);
+    rd_push_word(output, beat, slot, w, flush, last);
+}
+
+// 输入帧同步 (input_adaptor / pc_shared_load / radar_top_sw 共用)
+// 每个脉冲固定交出 N_RANGE 个样点，脉冲边界以 TLAST 为准，链路多 / 少样点只影响出错的脉冲：
+//   短包：第 i < N_RANGE-1 个样点已带 TLAST，余下样点补零 (不读输入)，rx_err bit0
+//   长包：读满 N_RANGE 个样点仍无 TLAST，读掉多余样点直到 TLAST，rx_err bit1
+// TLAST 约定由调用方明确给出 (radar_ctrl_t.tlast_pulse，独立脉压顶层固定为逐脉冲)，不从数据推断：
+//   逐脉冲：每个脉冲读满而无 TLAST 都是长包，一律读到 TLAST
+//   整次调用：脉冲之间没有边界可查，只有最后一个脉冲按长包处理；逐脉冲 TLAST 的无错输入在这一约定下结果相同，
+//            但中间脉冲的长包会错位到下一个脉冲 (短包) 才恢复
+struct rx_sync_t {
+    bool eop;         // 本脉冲已收到 TLAST
+    bool per_pulse;   // 输入为逐脉冲 TLAST
+    ap_uint<2> err;   // 本脉冲 rx_err
+};
+
+// 每次调用开始时清零
+inline void rx_sync_init(rx_sync_t &s, bool per_pulse) {
+    #pragma HLS INLINE
+    s.eop = false;
+    s.per_pulse = per_pulse;
+    s.err = 0;
+}
+
+// 脉冲第 i 个样点：本脉冲已收到 TLAST 时返回全零样点
+inline axis_in_t rx_sync_beat(stream_in_t &in, rx_sync_t &s, int i) {
+    #pragma HLS INLINE
+    axis_in_t pkt;
+    pkt.data = 0;
+    pkt.last = 0;
+    pkt.user = 0;
+    if (i == 0) {
+        s.eop = false;
+        s.err = 0;
+    }
+    if (s.eop) s.err[0] = 1;
+    else pkt = in.read();
+    s.eop = s.eop || pkt.last;
+    return pkt;
+}
+
+// 脉冲结束：长包时读掉余下样点，返回本脉冲 rx_err
+inline ap_uint<2> rx_sync_end(stream_in_t &in, rx_sync_t &s, bool last_pulse) {
+    #pragma HLS INLINE
+    if (!s.eop && (s.per_pulse || last_pulse)) {
+        s.err[1] = 1;
+        axis_in_t pkt;
+        do {
+            #pragma HLS PIPELINE II=1
+            #pragma HLS LOOP_TRIPCOUNT min=1 max=N_RANGE
+            pkt = in.read();
+        } while (!pkt.last);
+    }
+    return s.err;
+}
 
 // ==========================================
 // 4. 函数声明
 // ==========================================
-// 脉冲压缩
-void pulse_compression(stream_in_t &adc_input, stream_out_t &pc_output);
+// 脉冲压缩 (meta_out：每个脉冲输出一次 TUSER 元数据)
+void pulse_compression(stream_in_t &adc_input, stream_out_t &pc_output, stream_meta_t &meta_out);
+// 连续脉压：一次处理整个 CPI (n_pulse 个脉冲)，脉冲首尾相接
+// 输入逐脉冲 TLAST；tlast_per_pulse = false 时整次调用只有最后一个样点带 TLAST (radar_top_pc 按 ctrl 给出)
+void pulse_compression_cpi(stream_in_t &adc_input, stream_out_t &pc_output, stream_meta_t &meta_out,
+                           int n_pulse, bool tlast_per_pulse = true);
+// 连续脉压的内部形式：输出数据通路类型、不换算刻度 (radar_top Phase 1 直接接角转换存储)
+// n_taps > 0 时核心换成短码 FIR (与 pulse_compression_fir 相同)，否则为 FFT 匹配滤波；TLAST 约定同 pulse_compression_cpi
+void pulse_compression_cpi_dp(stream_in_t &adc_input, stream_dp_t &pc_output, stream_meta_t &meta_out,
+                              int n_pulse, const pc_fir_tap_t taps[PC_FIR_MAX_TAPS], int n_taps,
+                              bool tlast_per_pulse);
+// 共享 FFT 核 (RADAR_SHARED_FFT) 下脉压中 FFT 以外的两步，radar_top 逐脉冲调用：
+// 读一个 ADC 脉冲 (N_RANGE 个样点，按 sync 做 TLAST 重同步，元数据取第一个样点的 TUSER)；频谱乘匹配滤波系数 x = y * REF
+void pc_shared_load(stream_in_t &adc_input, dp_complex_t x[N_RANGE], pulse_meta_t &meta,
+                    rx_sync_t &sync, bool last_pulse);
+void pc_shared_match(const dp_complex_t y[N_RANGE], dp_complex_t x[N_RANGE]);
+
+// 数字下变频：实中频 -> 复基带 (axis_in_t 格式，每脉冲 N_RANGE 个样点)，n_pulse 个脉冲
+void radar_ddc(stream_if_t &if_input, stream_in_t &bb_output, ddc_ctrl_t ctrl, int n_pulse);
+// DDC 群延迟 (输出样点)：距离门起点应提前这么多个基带样点 (主机侧换算用)
+double ddc_group_delay(int cic_r);
+// 下变频 + 连续脉压 (中频直接进脉压，脉压只看到抽取后的速率)
+void pulse_compression_ddc(stream_if_t &if_input, stream_out_t &pc_output, stream_meta_t &meta_out,
+                           ddc_ctrl_t ctrl, int n_pulse);
+
+// 短码时域匹配滤波：格式与 pulse_compression_cpi 相同，FFT / 相乘 / IFFT 换成 FIR
+// taps[k] 为共轭后的码片 (前 n_taps 个有效，0 或超出上限按 PC_FIR_MAX_TAPS)，
+// 第 i 门输出 2^-PC_FIR_SHIFT * sum_k taps[k] * x[i+k]；脉冲末尾只累加本脉冲内的样点 (线性相关，FFT 版本为循环相关)
+void pulse_compression_fir(stream_in_t &adc_input, stream_out_t &pc_output, stream_meta_t &meta_out,
+                           const pc_fir_tap_t taps[PC_FIR_MAX_TAPS], int n_taps, int n_pulse);
 
 // 多普勒估计
-void doppler_est_top(stream_internal_t &in_stream, stream_internal_t &out_stream);
+void doppler_est_top(stream_dp_t &in_stream, stream_dp_t &out_stream);
+// 连续 N_RANGE 列的多普勒 FFT (列与列首尾相接)
+void doppler_est_stream(stream_dp_t &in_stream, stream_dp_t &out_stream);
+// 单目标频率估计：FFT + 峰值搜索 + 亚 bin 插值，输出 Hz
+void doppler_est_top(stream_internal_t &in_stream, float &estimated_freq);
+
+// 滑动 DFT 多普勒：每次调用处理一个脉冲，输出 N_RANGE * n_bins 个单元 (距离门优先)
+void radar_sdft_top(stream_in_t &input,
+                    stream_rd_t &output,
+                    stream_meta_t &meta_out,
+                    sdft_ctrl_t ctrl);
+
+// 处理级组合 (编译期策略)：同一份源码实例化不同的核，综合时只生成用到的级
+//   radar_stages_pc         : 只有脉压，逐脉冲输出距离像            -> radar_top_pc
+//   radar_stages_pc_dop     : 脉压 + 角转换 + 多普勒，输出帧头 + RD 图 -> radar_top
+//   radar_stages_pc_dop_det : 再加 CFAR 检测，另有检测列表输出口     -> radar_top_det
+//   radar_stages_pc_dop_tap : 与 pc_dop 相同，另有逐脉冲距离像旁路   -> radar_top_tap
+template <bool DOP, bool DET, bool TAP = false>
+struct radar_stage_policy {
+    static const bool doppler = DOP;
+    static const bool detect = DOP && DET;   // 检测依赖多普勒
+    static const bool tap = DOP && TAP;      // 只有脉压时输出本身就是距离像
+};
+typedef radar_stage_policy<false, false> radar_stages_pc;
+typedef radar_stage_policy<true, false>  radar_stages_pc_dop;
+typedef radar_stage_policy<true, true>   radar_stages_pc_dop_det;
+typedef radar_stage_policy<true, false, true> radar_stages_pc_dop_tap;
+
+// 通用顶层 (radar_top.cpp 中对上述四种策略显式实例化)
+// 策略不用的端口不读不写；各部署的顶层函数只把自己用到的端口引出
+template <class STAGES>
+void radar_top_t(stream_in_t &input,
+                 stream_rd_t &output,
+                 stream_meta_t &meta_out,      // PC / TAP：每脉冲 TUSER 元数据
+                 stream_det_t &det_output,     // 仅 DET：检测列表 + 尾字
+                 stream_rd_t &tap_output,      // 仅 TAP：逐脉冲距离像
+                 radar_ctrl_t ctrl,
+                 cfar_ctrl_t cfar_ctrl,
+                 tap_ctrl_t tap_ctrl,
+                 const dop_win_t dop_win[N_PULSE],
+                 const pc_fir_tap_t pc_fir_tap[PC_FIR_MAX_TAPS],  // PC 不读，可为空
+                 ap_uint<32> *dbg_fft_in_cnt,  // 进入多普勒 FFT 的单元数 (PC 没有多普勒 FFT，恒为 0)
+                 ap_uint<32> *dbg_fft_out_cnt); // FFT 输出单元数 (PC：输出的距离像单元数)
 
 // 顶层函数
 //void radar_top(stream_in_t &input, stream_out_t &output);
 void radar_top(stream_in_t &input,
-               stream_out_t &output,
+               stream_rd_t &output,
+               radar_ctrl_t ctrl,
+               const dop_win_t dop_win[N_PULSE],  // 慢时间窗 (BRAM 口，主机在 CPI 之间改写)
+               const pc_fir_tap_t pc_fir_tap[PC_FIR_MAX_TAPS],  // 短码 FIR 抽头，共轭后的码片 (BRAM 口，pc_fir_taps = 0 时不读)
                ap_uint<32> *dbg_fft_in_cnt,  // 【新增】调试输出端口
                ap_uint<32> *dbg_fft_out_cnt) ;// 【新增】调试输出端口
+
+// 只有脉压的核：n_pulse 个脉冲连续脉压，每个脉冲 N_RANGE 个单元 (TLAST 在脉冲末尾)，
+// 元数据从 meta_out 输出；ctrl 只用 n_pulse 与 tlast_pulse (脉压固定为 FFT 匹配滤波，短码用 pulse_compression_fir)
+void radar_top_pc(stream_in_t &input,
+                  stream_rd_t &output,
+                  stream_meta_t &meta_out,
+                  radar_ctrl_t ctrl);
+
+// 带检测的核：output 与 radar_top 相同 (只支持距离优先)，det_output 随 RD 图逐列给出检测，帧末一个尾字
+void radar_top_det(stream_in_t &input,
+                   stream_rd_t &output,
+                   stream_det_t &det_output,
+                   radar_ctrl_t ctrl,
+                   cfar_ctrl_t cfar_ctrl,
+                   const dop_win_t dop_win[N_PULSE],
+                   const pc_fir_tap_t pc_fir_tap[PC_FIR_MAX_TAPS],
+                   ap_uint<32> *dbg_fft_in_cnt,
+                   ap_uint<32> *dbg_fft_out_cnt);
+
+// 带距离像旁路的核：output 与 radar_top 相同；tap_output 每个输入脉冲 (预积累之前) 一个 TLAST 包，
+// N_RANGE >> decim_log2 个单元，对应的元数据从 meta_out 输出；旁路关闭时两个旁路口都不写
+// 旁路下游跟不上时按整个脉冲丢弃 (包与元数据都不写)，主通路不受影响；丢弃数见帧头字 10
+void radar_top_tap(stream_in_t &input,
+                   stream_rd_t &output,
+                   stream_rd_t &tap_output,
+                   stream_meta_t &meta_out,
+                   radar_ctrl_t ctrl,
+                   tap_ctrl_t tap_ctrl,
+                   const dop_win_t dop_win[N_PULSE],
+                   const pc_fir_tap_t pc_fir_tap[PC_FIR_MAX_TAPS],
+                   ap_uint<32> *dbg_fft_in_cnt,
+                   ap_uint<32> *dbg_fft_out_cnt);
+
+// 软件后端 (radar_sw.cpp)，接口与 radar_top 完全一致
+void radar_top_sw(stream_in_t &input,
+                  stream_rd_t &output,
+                  radar_ctrl_t ctrl,
+                  const dop_win_t dop_win[N_PULSE],
+                  const pc_fir_tap_t pc_fir_tap[PC_FIR_MAX_TAPS],
+                  ap_uint<32> *dbg_fft_in_cnt,
+                  ap_uint<32> *dbg_fft_out_cnt);
 #endif
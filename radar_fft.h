@@ -0,0 +1,290 @@
+#ifndef RADAR_FFT_H
+#define RADAR_FFT_H
+
+#include "radar_defines.h"
+
+// ==========================================
+// FFT 调用入口 radar_fft<CFG>()，参数与 hls::fft<CFG>() 完全相同
+// 综合时 / 默认 C-sim 时直接调用 hls::fft (Xilinx 位精确模型)
+// RADAR_FAST_FFT   : C-sim 改用本文件的原生定点 FFT (整数运算，逐级按 setSch 缩放)
+// RADAR_FFT_XCHECK : 两者都跑，输出仍取 hls::fft 的结果，逐点比较并统计最大 LSB 误差
+//
+// 浮点数据通路 (RADAR_FLOAT_DATAPATH) 的 std::complex<float> 流始终走 hls::fft
+//
+// 原生模型与 pipelined_streaming_io 的数值语义一致：
+//   - 输入 / 输出均为 Q1.(W-1)，W = input_width / output_width
+//   - radix-2 DIF，每两级 (一个 radix-4 级) 后按 sch 的 2bit 字段算术右移 (截断)，
+//     级数为奇数时最后一个 radix-2 级用最高字段
+//   - 旋转因子 phase_factor_width 位 (四舍五入)，乘积截断
+//   - 输出按 ordering_opt 给出自然序 / 位反序，超出输出位宽时回绕并置 ovflo
+// 内部级间不做位宽限制 (IP 内部有保护位)，因此与 IP 只差截断误差，不保证逐位一致
+// 实现：每个点数预先算好逐级旋转因子表与位反序表，相邻两级在一次 radix-4 遍历中做完，
+// 流数据按位拷贝进出整数工作区 (不经 double 换算)
+// ==========================================
+
+#if !defined(__SYNTHESIS__) && (defined(RADAR_FAST_FFT) || defined(RADAR_FFT_XCHECK))
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <atomic>
+#include <algorithm>
+#include <cstdlib>
+
+// 交叉校验统计 (全局，C-sim 结束时由 TB 打印)
+struct radar_fft_xcheck_t {
+    std::atomic<long> frames;
+    std::atomic<long> bad_frames;     // 有点误差超过 RADAR_FFT_XCHECK_TOL 的帧数
+    std::atomic<long> ovflo_diff;     // ovflo 标志不一致的帧数
+    std::atomic<int>  max_lsb;        // 最大单点误差 (输出 LSB)
+};
+
+#ifndef RADAR_FFT_XCHECK_TOL
+#define RADAR_FFT_XCHECK_TOL 8        // 允许的最大误差 (LSB)，逐级截断在低缩放调度下会累积
+#endif
+
+inline radar_fft_xcheck_t &radar_fft_xcheck_stats() {
+    static radar_fft_xcheck_t st{ {0}, {0}, {0}, {0} };
+    return st;
+}
+
+// 预计算的 FFT 计划 (每个 CFG、每个点数一份，首次使用时建立)
+// 每个 radix-2 级一段连续的旋转因子 W^(j*step)，j < half，正变换与反变换各一份 (反变换虚部取负)，
+// 核心循环里不再按步长跳着取表；另存位反序表
+//   W^k = exp(-j*2*pi*k/N)，phase_factor_width 位 (四舍五入)，+1.0 不可表示，饱和到最大值
+template <class CFG>
+struct radar_fft_plan {
+    int log2n;
+    std::vector<int> stage_off;             // 第 s 级 (half = n >> (s+1)) 在表中的起点
+    std::vector<int64_t> wr, wi_fwd, wi_inv;
+    std::vector<int> rev;
+
+    explicit radar_fft_plan(int l) : log2n(l), stage_off(l), rev(1 << l) {
+        const int n = 1 << l;
+        const int nmax = 1 << CFG::max_nfft;
+        const double q = std::ldexp(1.0, CFG::phase_factor_width - 1);
+        const int64_t qmax = (int64_t)q - 1;
+        for (int s = 0, half = n / 2; s < l; s++, half >>= 1) {
+            stage_off[s] = (int)wr.size();
+            // 与最大点数的表按步长取值相同 (运行时更短的点数)
+            const int step = (n / (2 * half)) * (nmax / n);
+            for (int j = 0; j < half; j++) {
+                double a = -2.0 * M_PI * (double)(j * step) / nmax;
+                int64_t c = (int64_t)std::floor(std::cos(a) * q + 0.5);
+                int64_t d = (int64_t)std::floor(std::sin(a) * q + 0.5);
+                c = c > qmax ? qmax : c;
+                d = d > qmax ? qmax : d;
+                wr.push_back(c);
+                wi_fwd.push_back(d);
+                wi_inv.push_back(-d);
+            }
+        }
+        for (int i = 0; i < n; i++) {
+            int r = 0;
+            for (int b = 0; b < l; b++) r |= ((i >> b) & 1) << (l - 1 - b);
+            rev[i] = r;
+        }
+    }
+};
+
+template <class CFG>
+static const radar_fft_plan<CFG> &radar_fft_get_plan(int log2n) {
+    struct plans_t {
+        std::vector<radar_fft_plan<CFG> > p;
+        plans_t() {
+            for (int l = 0; l <= (int)CFG::max_nfft; l++) p.push_back(radar_fft_plan<CFG>(l));
+        }
+    };
+    static const plans_t plans;
+    return plans.p[log2n];
+}
+
+// radix-2 蝶形：a' = a + b，b' = ((a - b) * w) >> pf (乘积截断)
+#define RADAR_FFT_BFLY(ar, ai, br, bi, wr_, wi_)            \
+    do {                                                     \
+        const int64_t dr_ = (ar) - (br), di_ = (ai) - (bi);  \
+        (ar) += (br);                                        \
+        (ai) += (bi);                                        \
+        (br) = (dr_ * (wr_) - di_ * (wi_)) >> pf;            \
+        (bi) = (dr_ * (wi_) + di_ * (wr_)) >> pf;            \
+    } while (0)
+
+// 单帧原生 FFT：x_re/x_im 为输入原始整数 (Q1.(in_w-1))，原位输出原始整数 (Q1.(out_w-1))
+// 返回是否溢出
+// 相邻两个 radix-2 级合成一个 radix-4 遍历 (每组 4 个点在寄存器里做完两级再按 sch 右移)，
+// 运算与逐级 radix-2 完全相同，只是数据少读写一半；级数为奇数时最后一级单独做
+template <class CFG>
+static bool radar_fft_native(int64_t *x_re, int64_t *x_im, int log2n, bool fwd, unsigned sch) {
+    const int n = 1 << log2n;
+    const radar_fft_plan<CFG> &plan = radar_fft_get_plan<CFG>(log2n);
+    const int pf = CFG::phase_factor_width - 1;
+    const bool scaled = (CFG::scaling_opt == hls::ip_fft::scaled);
+    const int64_t *wr = plan.wr.data();
+    const int64_t *wi = fwd ? plan.wi_fwd.data() : plan.wi_inv.data();
+
+    int level = 0;
+    for (; level + 1 < log2n; level += 2) {
+        const int h = n >> (level + 1), h2 = h / 2;
+        const int64_t *wr1 = wr + plan.stage_off[level], *wi1 = wi + plan.stage_off[level];
+        const int64_t *wr2 = wr + plan.stage_off[level + 1], *wi2 = wi + plan.stage_off[level + 1];
+        const int sh = scaled ? (int)((sch >> level) & 3) : 0;
+        for (int b = 0; b < n; b += 2 * h) {
+            int64_t *pr = x_re + b, *pi = x_im + b;
+            for (int j = 0; j < h2; j++) {
+                int64_t r0 = pr[j], r1 = pr[j + h2], r2 = pr[j + h], r3 = pr[j + h + h2];
+                int64_t i0 = pi[j], i1 = pi[j + h2], i2 = pi[j + h], i3 = pi[j + h + h2];
+                RADAR_FFT_BFLY(r0, i0, r2, i2, wr1[j], wi1[j]);
+                RADAR_FFT_BFLY(r1, i1, r3, i3, wr1[j + h2], wi1[j + h2]);
+                RADAR_FFT_BFLY(r0, i0, r1, i1, wr2[j], wi2[j]);
+                RADAR_FFT_BFLY(r2, i2, r3, i3, wr2[j], wi2[j]);
+                pr[j] = r0 >> sh;      pi[j] = i0 >> sh;
+                pr[j + h2] = r1 >> sh; pi[j + h2] = i1 >> sh;
+                pr[j + h] = r2 >> sh;  pi[j + h] = i2 >> sh;
+                pr[j + h + h2] = r3 >> sh;
+                pi[j + h + h2] = i3 >> sh;
+            }
+        }
+    }
+    if (level < log2n) {
+        // 奇数级数：最后一个 radix-2 级 (half = 1) 用最高的 sch 字段
+        const int64_t w_r = wr[plan.stage_off[level]], w_i = wi[plan.stage_off[level]];
+        const int sh = scaled ? (int)((sch >> level) & 3) : 0;
+        for (int b = 0; b < n; b += 2) {
+            int64_t r0 = x_re[b], r1 = x_re[b + 1], i0 = x_im[b], i1 = x_im[b + 1];
+            RADAR_FFT_BFLY(r0, i0, r1, i1, w_r, w_i);
+            x_re[b] = r0 >> sh;
+            x_im[b] = i0 >> sh;
+            x_re[b + 1] = r1 >> sh;
+            x_im[b + 1] = i1 >> sh;
+        }
+    }
+
+    // 输出位宽回绕 + 溢出检测 (输入输出同为 Q1 格式，LSB 差 in_w - out_w 位)
+    const int dw = (int)CFG::input_width - (int)CFG::output_width;
+    const int64_t lim = (int64_t)1 << (CFG::output_width - 1);
+    bool ovf = false;
+    for (int i = 0; i < 2 * n; i++) {
+        int64_t &v = i < n ? x_re[i] : x_im[i - n];
+        int64_t t = dw >= 0 ? (v >> dw) : (v << -dw);
+        if (t >= lim || t < -lim) {
+            ovf = true;
+            t = ((t + lim) & (2 * lim - 1)) - lim;
+        }
+        v = t;
+    }
+
+    // DIF 输出为位反序
+    if (CFG::ordering_opt == hls::ip_fft::natural_order) {
+        const int *rev = plan.rev.data();
+        for (int i = 0; i < n; i++) {
+            if (i < rev[i]) {
+                std::swap(x_re[i], x_re[rev[i]]);
+                std::swap(x_im[i], x_im[rev[i]]);
+            }
+        }
+    }
+    return ovf;
+}
+#undef RADAR_FFT_BFLY
+
+// 流数据与原始整数之间按位拷贝 (hls::fft 要求流元素为 ap_fixed<input_width / output_width, 1>)
+template <int W, class T>
+inline int64_t radar_fft_to_raw(const T &v) {
+    ap_int<W> r;
+    r.range(W - 1, 0) = v.range(W - 1, 0);
+    return r.to_int64();
+}
+
+template <int W, class T>
+inline T radar_fft_from_raw(int64_t x) {
+    T v;
+    v.range(W - 1, 0) = ap_int<W>(x);
+    return v;
+}
+#endif
+
+// 配置字：方向 + 缩放调度 (不缩放的配置，如浮点数据通路，没有 sch 字段)
+template <class CFG>
+inline hls::ip_fft::config_t<CFG> radar_fft_cfg(bool fwd, unsigned sch) {
+    #pragma HLS INLINE
+    hls::ip_fft::config_t<CFG> cfg;
+    cfg.setDir(fwd);
+    if (CFG::scaling_opt == hls::ip_fft::scaled) cfg.setSch(sch);
+    return cfg;
+}
+
+// 浮点数据通路：hls::fft 的浮点 C 模型本身不是位精确模型，直接调用
+template <class CFG>
+inline void radar_fft(hls::stream<std::complex<float> > &in, hls::stream<std::complex<float> > &out,
+                      hls::stream<hls::ip_fft::status_t<CFG> > &sts,
+                      hls::stream<hls::ip_fft::config_t<CFG> > &cfg_s) {
+    #pragma HLS INLINE
+    hls::fft<CFG>(in, out, sts, cfg_s);
+}
+
+template <class CFG, class TI, class TO>
+inline void radar_fft(hls::stream<std::complex<TI> > &in, hls::stream<std::complex<TO> > &out,
+                      hls::stream<hls::ip_fft::status_t<CFG> > &sts,
+                      hls::stream<hls::ip_fft::config_t<CFG> > &cfg_s) {
+    #pragma HLS INLINE
+#if defined(__SYNTHESIS__) || !(defined(RADAR_FAST_FFT) || defined(RADAR_FFT_XCHECK))
+    hls::fft<CFG>(in, out, sts, cfg_s);
+#else
+    hls::ip_fft::config_t<CFG> cfg = cfg_s.read();
+    const int log2n = CFG::has_nfft ? (int)cfg.getNfft() : (int)CFG::max_nfft;
+    const int n = 1 << log2n;
+
+    // 每线程一份工作区，帧间复用
+    static thread_local std::vector<int64_t> x_re, x_im;
+    x_re.resize(n);
+    x_im.resize(n);
+#ifdef RADAR_FFT_XCHECK
+    hls::stream<std::complex<TI> > ref_in;
+    hls::stream<std::complex<TO> > ref_out;
+    hls::stream<hls::ip_fft::status_t<CFG> > ref_sts;
+    hls::stream<hls::ip_fft::config_t<CFG> > ref_cfg;
+    ref_cfg.write(cfg);
+#endif
+    for (int i = 0; i < n; i++) {
+        std::complex<TI> v = in.read();
+        x_re[i] = radar_fft_to_raw<CFG::input_width>(v.real());
+        x_im[i] = radar_fft_to_raw<CFG::input_width>(v.imag());
+#ifdef RADAR_FFT_XCHECK
+        ref_in.write(v);
+#endif
+    }
+
+    bool ovf = radar_fft_native<CFG>(x_re.data(), x_im.data(), log2n, cfg.getDir() != 0, cfg.getSch());
+
+#ifdef RADAR_FFT_XCHECK
+    const double out_q = std::ldexp(1.0, CFG::output_width - 1);
+    hls::fft<CFG>(ref_in, ref_out, ref_sts, ref_cfg);
+    hls::ip_fft::status_t<CFG> st = ref_sts.read();
+    int max_lsb = 0;
+    for (int i = 0; i < n; i++) {
+        std::complex<TO> r = ref_out.read();
+        int64_t rr = (int64_t)std::floor(r.real().to_double() * out_q + 0.5);
+        int64_t ri = (int64_t)std::floor(r.imag().to_double() * out_q + 0.5);
+        int64_t e = std::max(std::llabs(rr - x_re[i]), std::llabs(ri - x_im[i]));
+        if (e > max_lsb) max_lsb = (int)e;
+        out.write(r);
+    }
+    radar_fft_xcheck_t &xs = radar_fft_xcheck_stats();
+    xs.frames++;
+    if (max_lsb > RADAR_FFT_XCHECK_TOL) xs.bad_frames++;
+    if ((st.getOvflo() != 0) != ovf) xs.ovflo_diff++;
+    int prev = xs.max_lsb.load();
+    while (max_lsb > prev && !xs.max_lsb.compare_exchange_weak(prev, max_lsb)) {}
+    sts.write(st);
+#else
+    for (int i = 0; i < n; i++) {
+        out.write(std::complex<TO>(radar_fft_from_raw<CFG::output_width, TO>(x_re[i]),
+                                   radar_fft_from_raw<CFG::output_width, TO>(x_im[i])));
+    }
+    hls::ip_fft::status_t<CFG> st;
+    st.setOvflo(ovf ? 1 : 0);
+    sts.write(st);
+#endif
+#endif
+}
+
+#endif
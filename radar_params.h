@@ -0,0 +1,17 @@
+#ifndef RADAR_PARAMS_H
+#define RADAR_PARAMS_H
+
+// ==========================================
+// 系统尺寸与波形参数 (不依赖 HLS 头文件)
+// radar_defines.h 包含本文件；主机侧工具 (gen_scene 等) 只需这些常量时直接包含，
+// 不用 HLS 库即可用普通编译器构建
+// ==========================================
+#define N_RANGE 128
+#define N_PULSE 128   // 多普勒 FFT 长度；实际 CPI 脉冲数由 radar_ctrl_t.n_pulse 运行时给出，不足部分补零
+
+// LFM 波形参数 (与 gen_data_2d.py 一致)
+#define LFM_FS   20000.0   // 采样率 (Hz)
+#define LFM_BW   10000.0   // 带宽 (Hz)，脉宽 = N_RANGE / LFM_FS
+#define ADC_BITS 14
+
+#endif
@@ -0,0 +1,380 @@
+#include "radar_pipeline.h"
+#include <cstdlib>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// ==========================================================================
+// 1. 帧缓冲池
+// 所有帧的输入/输出字放在同一块对齐内存中，构造后不再分配
+// ==========================================================================
+static size_t align_up(size_t n, size_t a) {
+    return (n + a - 1) / a * a;
+}
+
+RadarBufferPool::RadarBufferPool(int n_frames)
+    : slab_(nullptr), slab_bytes_(0), locked_(false),
+      frames_(n_frames), win_((size_t)n_frames * N_PULSE),
+      fir_((size_t)n_frames * PC_FIR_MAX_TAPS), free_(n_frames) {
+    const size_t in_bytes = align_up(RADAR_IN_WORDS * sizeof(uint32_t), 64);
+    const size_t user_bytes = align_up(PRESUM_MAX_PULSES * sizeof(uint64_t), 64);
+    const size_t out_bytes = align_up(RADAR_OUT_WORDS * sizeof(uint32_t), 64);
+    const size_t per_frame = in_bytes + user_bytes + out_bytes;
+    slab_bytes_ = per_frame * n_frames;
+    if (posix_memalign(&slab_, 64, slab_bytes_) != 0) {
+        // 池保持为空并关闭空闲队列，acquire 立即返回 nullptr 而不是永远阻塞
+        slab_ = nullptr;
+        free_.close();
+        return;
+    }
+    memset(slab_, 0, slab_bytes_);
+    // 锁页：DMA 缓冲不能被换出 (非 root 时可能因 RLIMIT_MEMLOCK 失败)
+    locked_ = (mlock(slab_, slab_bytes_) == 0);
+
+    char *p = (char *)slab_;
+    for (int i = 0; i < n_frames; i++) {
+        RadarFrame &f = frames_[i];
+        f.ctrl = radar_ctrl_t();
+        f.seq = 0;
+        f.in_words = (uint32_t *)p;
+        f.pulse_user = (uint64_t *)(p + in_bytes);
+        f.out_words = (uint32_t *)(p + in_bytes + user_bytes);
+        f.dop_win = &win_[(size_t)i * N_PULSE];
+        for (int k = 0; k < N_PULSE; k++) f.dop_win[k] = 1;
+        f.pc_fir_tap = &fir_[(size_t)i * PC_FIR_MAX_TAPS];
+        f.out_count = 0;
+        f.status = 0;
+        f.pool_index = i;
+        p += per_frame;
+        free_.push(&f);
+    }
+}
+
+RadarBufferPool::~RadarBufferPool() {
+    if (slab_) {
+        if (locked_) munlock(slab_, slab_bytes_);
+        free(slab_);
+    }
+}
+
+RadarFrame *RadarBufferPool::acquire() {
+    RadarFrame *f = nullptr;
+    free_.pop(f);
+    return f;
+}
+
+bool RadarBufferPool::try_acquire(RadarFrame *&f) {
+    return free_.try_pop(f);
+}
+
+void RadarBufferPool::release(RadarFrame *f) {
+    if (f) free_.push(f);
+}
+
+// ==========================================================================
+// 2. 帧 <-> axis 流
+// ==========================================================================
+void radar_frame_run(radar_top_fn_t fn, RadarFrame &f) {
+    if (!f.in_words || !f.out_words) {
+        f.out_count = 0;
+        f.status = -1;
+        return;
+    }
+    stream_in_t in_strm;
+    stream_rd_t out_strm;
+    ap_uint<32> dbg_in = 0, dbg_out = 0;
+
+    const int n_words = radar_ctrl_in_pulses(f.ctrl) * N_RANGE;
+    for (int i = 0; i < n_words; i++) {
+        axis_in_t pkt;
+        pkt.data = f.in_words[i];
+        // 按 ctrl.tlast_pulse 约定给出 TLAST：逐脉冲或整帧一个
+        pkt.last = f.ctrl.tlast_pulse ? (i % N_RANGE == N_RANGE - 1) : (i == n_words - 1);
+        pkt.keep = -1;
+        pkt.strb = -1;
+        pkt.user = (i % N_RANGE == 0) ? ap_uint<PULSE_META_W>(f.pulse_user[i / N_RANGE]) : ap_uint<PULSE_META_W>(0);
+        in_strm.write(pkt);
+    }
+
+    fn(in_strm, out_strm, f.ctrl, f.dop_win, f.pc_fir_tap, &dbg_in, &dbg_out);
+
+    int n = 0;
+    bool last_seen = false;
+    while (!out_strm.empty()) {
+        axis_rd_t beat = out_strm.read();
+        int cells = rd_beat_cells(beat);
+        for (int k = 0; k < cells && n < RADAR_OUT_WORDS; k++) {
+            f.out_words[n++] = rd_beat_word(beat, k).to_uint();
+        }
+        if (beat.last) last_seen = true;
+    }
+    f.out_count = n;
+    f.status = (n == radar_frame_out_words(f.ctrl) && last_seen && in_strm.empty()) ? 0 : -1;
+}
+
+// ==========================================================================
+// 3. 共享内存 DMA 模拟器
+// ==========================================================================
+#define RADAR_SHM_MAGIC 0x52534D31   // "RSM1"
+
+enum { SHM_SLOT_FREE = 0, SHM_SLOT_SUBMITTED = 1, SHM_SLOT_DONE = 2 };
+
+struct radar_shm_slot_t {
+    std::atomic<uint32_t> state;
+    uint32_t ctrl_word;            // [0] dop_major [1] dop_shift [2] win_en [4:3] presum_log2 [5] tlast_pulse [14:8] pc_fir_taps
+                                   // [31:16] n_pulse
+    uint32_t presum_fcw;
+    uint32_t band_word;            // [15:0] dop_first [31:16] dop_bins
+    int32_t  status;
+    uint32_t out_count;
+    uint32_t in_words[RADAR_IN_WORDS];
+    uint64_t pulse_user[PRESUM_MAX_PULSES];
+    uint16_t dop_win[N_PULSE];     // dop_win_t 原始位
+    uint64_t pc_fir_tap[PC_FIR_MAX_TAPS];  // 短码 FIR 抽头原始位 [17:0] 实部 [49:32] 虚部
+    uint32_t out_words[RADAR_OUT_WORDS];
+};
+
+struct radar_shm_region_t {
+    uint32_t magic;
+    uint32_t n_slots;
+    std::atomic<uint32_t> quit;
+    uint32_t reserved;
+    radar_shm_slot_t slot[1];      // 实际为 n_slots 个
+};
+
+static size_t shm_region_bytes(int n_slots) {
+    return sizeof(radar_shm_region_t) + (size_t)(n_slots - 1) * sizeof(radar_shm_slot_t);
+}
+
+static uint32_t shm_pack_ctrl(radar_ctrl_t c) {
+    return (uint32_t)c.dop_major | ((uint32_t)c.dop_shift << 1) | ((uint32_t)c.win_en << 2)
+         | ((uint32_t)c.presum_log2 << 3) | ((uint32_t)c.tlast_pulse << 5) | ((uint32_t)c.pc_fir_taps << 8) | ((uint32_t)c.n_pulse << 16);
+}
+
+static radar_ctrl_t shm_unpack_ctrl(uint32_t w, uint32_t fcw, uint32_t band) {
+    radar_ctrl_t c;
+    c.dop_major = w & 1;
+    c.dop_shift = (w >> 1) & 1;
+    c.win_en = (w >> 2) & 1;
+    c.presum_log2 = (w >> 3) & 3;
+    c.tlast_pulse = (w >> 5) & 1;
+    c.pc_fir_taps = (w >> 8) & 0x7F;
+    c.n_pulse = w >> 16;
+    c.presum_fcw = fcw;
+    c.dop_first = band & 0xFFFF;
+    c.dop_bins = band >> 16;
+    return c;
+}
+
+static void shm_wait_state(std::atomic<uint32_t> &st, uint32_t want, const std::atomic<uint32_t> *quit) {
+    int spins = 0;
+    while (st.load(std::memory_order_acquire) != want) {
+        if (quit && quit->load(std::memory_order_relaxed)) return;
+        if (++spins < 1000) std::this_thread::yield();
+        else usleep(50);
+    }
+}
+
+// --- 设备侧 ---
+RadarShmDevice::RadarShmDevice(const std::string &shm_name, radar_top_fn_t fn)
+    : region_(nullptr), map_bytes_(0), owns_map_(true), fn_(fn) {
+    int fd = shm_open(shm_name.c_str(), O_RDWR, 0600);
+    if (fd < 0) return;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(radar_shm_region_t)) {
+        void *p = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p != MAP_FAILED) {
+            region_ = (radar_shm_region_t *)p;
+            map_bytes_ = st.st_size;
+            if (region_->magic != RADAR_SHM_MAGIC || shm_region_bytes(region_->n_slots) > map_bytes_) {
+                munmap(p, map_bytes_);
+                region_ = nullptr;
+            }
+        }
+    }
+    close(fd);
+}
+
+RadarShmDevice::RadarShmDevice(radar_shm_region_t *region, radar_top_fn_t fn)
+    : region_(region), map_bytes_(0), owns_map_(false), fn_(fn) {}
+
+RadarShmDevice::~RadarShmDevice() {
+    if (owns_map_ && region_) munmap(region_, map_bytes_);
+}
+
+void RadarShmDevice::run() {
+    if (!region_) return;
+    // 设备侧把槽内数据当作 DMA 读入的帧：RadarFrame 直接指向共享区，只有窗系数与 FIR 抽头需要转换
+    std::vector<dop_win_t> win(N_PULSE);
+    std::vector<pc_fir_tap_t> fir(PC_FIR_MAX_TAPS);
+    RadarFrame f;
+    uint32_t s = 0;
+    while (!region_->quit.load(std::memory_order_relaxed)) {
+        radar_shm_slot_t &slot = region_->slot[s];
+        shm_wait_state(slot.state, SHM_SLOT_SUBMITTED, &region_->quit);
+        if (region_->quit.load(std::memory_order_relaxed)) break;
+
+        f.ctrl = shm_unpack_ctrl(slot.ctrl_word, slot.presum_fcw, slot.band_word);
+        for (int t = 0; t < PC_FIR_MAX_TAPS; t++) {
+            pc_fir_tap_t::value_type re, im;
+            re.range(17, 0) = ap_uint<18>(slot.pc_fir_tap[t] & 0x3FFFF);
+            im.range(17, 0) = ap_uint<18>((slot.pc_fir_tap[t] >> 32) & 0x3FFFF);
+            fir[t] = pc_fir_tap_t(re, im);
+        }
+        f.pc_fir_tap = fir.data();
+        f.in_words = slot.in_words;
+        f.pulse_user = slot.pulse_user;
+        f.out_words = slot.out_words;
+        for (int k = 0; k < N_PULSE; k++) win[k].range(15, 0) = slot.dop_win[k];
+        f.dop_win = win.data();
+        radar_frame_run(fn_, f);
+        slot.out_count = f.out_count;
+        slot.status = f.status;
+        slot.state.store(SHM_SLOT_DONE, std::memory_order_release);
+
+        s = (s + 1) % region_->n_slots;
+    }
+}
+
+// --- 主机侧 ---
+RadarShmDmaTransport::RadarShmDmaTransport(radar_top_fn_t device_fn, int n_slots,
+                                           const std::string &shm_name, bool spawn_device)
+    : region_(nullptr), map_bytes_(shm_region_bytes(n_slots)), shm_name_(shm_name),
+      n_slots_(n_slots), next_start_(0), next_finish_(0), device_(nullptr) {
+    void *p = MAP_FAILED;
+    if (shm_name_.empty()) {
+        p = mmap(nullptr, map_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    } else {
+        int fd = shm_open(shm_name_.c_str(), O_CREAT | O_RDWR, 0600);
+        if (fd >= 0) {
+            if (ftruncate(fd, map_bytes_) == 0) {
+                p = mmap(nullptr, map_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            }
+            close(fd);
+        }
+    }
+    if (p == MAP_FAILED) return;
+
+    region_ = (radar_shm_region_t *)p;
+    memset(p, 0, map_bytes_);
+    region_->n_slots = n_slots;
+    region_->quit.store(0);
+    region_->magic = RADAR_SHM_MAGIC;
+
+    if (spawn_device) {
+        device_ = new RadarShmDevice(region_, device_fn);
+        device_thread_ = std::thread(&RadarShmDevice::run, device_);
+    }
+}
+
+RadarShmDmaTransport::~RadarShmDmaTransport() {
+    if (region_) region_->quit.store(1);
+    if (device_thread_.joinable()) device_thread_.join();
+    delete device_;
+    if (region_) {
+        munmap(region_, map_bytes_);
+        if (!shm_name_.empty()) shm_unlink(shm_name_.c_str());
+    }
+}
+
+// MM2S：拷入槽并敲门铃
+void RadarShmDmaTransport::start(RadarFrame &f) {
+    if (!region_) {
+        f.status = -1;
+        return;
+    }
+    radar_shm_slot_t &slot = region_->slot[next_start_ % n_slots_];
+    shm_wait_state(slot.state, SHM_SLOT_FREE, nullptr);
+
+    const int n_words = radar_ctrl_in_pulses(f.ctrl) * N_RANGE;
+    memcpy(slot.in_words, f.in_words, n_words * sizeof(uint32_t));
+    memcpy(slot.pulse_user, f.pulse_user, radar_ctrl_in_pulses(f.ctrl) * sizeof(uint64_t));
+    for (int k = 0; k < N_PULSE; k++) {
+        ap_uint<16> raw = f.dop_win[k].range(15, 0);
+        slot.dop_win[k] = raw.to_uint();
+    }
+    slot.ctrl_word = shm_pack_ctrl(f.ctrl);
+    for (int t = 0; t < PC_FIR_MAX_TAPS; t++) {
+        ap_uint<18> re = f.pc_fir_tap[t].real().range(17, 0);
+        ap_uint<18> im = f.pc_fir_tap[t].imag().range(17, 0);
+        slot.pc_fir_tap[t] = re.to_uint64() | ((uint64_t)im.to_uint64() << 32);
+    }
+    slot.presum_fcw = f.ctrl.presum_fcw.to_uint();
+    slot.band_word = f.ctrl.dop_first.to_uint() | (f.ctrl.dop_bins.to_uint() << 16);
+    slot.state.store(SHM_SLOT_SUBMITTED, std::memory_order_release);
+    next_start_++;
+}
+
+// S2MM：等待完成并取回
+void RadarShmDmaTransport::finish(RadarFrame &f) {
+    if (!region_) return;
+    radar_shm_slot_t &slot = region_->slot[next_finish_ % n_slots_];
+    shm_wait_state(slot.state, SHM_SLOT_DONE, nullptr);
+
+    f.out_count = slot.out_count;
+    f.status = slot.status;
+    memcpy(f.out_words, slot.out_words, slot.out_count * sizeof(uint32_t));
+    slot.state.store(SHM_SLOT_FREE, std::memory_order_release);
+    next_finish_++;
+}
+
+// ==========================================================================
+// 4. 异步流水线
+// ==========================================================================
+RadarPipeline::RadarPipeline(RadarTransport &tp, int n_buffers, int queue_depth)
+    : tp_(tp), pool_(n_buffers), in_q_(queue_depth), flight_q_(tp.depth()), out_q_(queue_depth),
+      submitted_(0), completed_(0), next_seq_(0) {
+    issue_thread_ = std::thread(&RadarPipeline::issue_loop, this);
+    complete_thread_ = std::thread(&RadarPipeline::complete_loop, this);
+}
+
+// 未取走的完成帧直接回收，保证收尾线程不会阻塞在输出队列上
+RadarPipeline::~RadarPipeline() {
+    in_q_.close();
+    RadarFrame *f;
+    while (out_q_.pop(f)) pool_.release(f);
+    issue_thread_.join();
+    complete_thread_.join();
+}
+
+void RadarPipeline::submit(RadarFrame *f) {
+    f->seq = next_seq_++;
+    f->status = 0;
+    f->out_count = 0;
+    submitted_++;
+    in_q_.push(f);
+}
+
+RadarFrame *RadarPipeline::wait_complete() {
+    RadarFrame *f = nullptr;
+    if (!out_q_.pop(f)) return nullptr;
+    completed_++;
+    return f;
+}
+
+bool RadarPipeline::try_complete(RadarFrame *&f) {
+    if (!out_q_.try_pop(f)) return false;
+    completed_++;
+    return true;
+}
+
+// 发起线程：flight_q_ 满 (传输层在途帧数达到 depth) 时自然阻塞
+void RadarPipeline::issue_loop() {
+    RadarFrame *f;
+    while (in_q_.pop(f)) {
+        tp_.start(*f);
+        flight_q_.push(f);
+    }
+    flight_q_.close();
+}
+
+void RadarPipeline::complete_loop() {
+    RadarFrame *f;
+    while (flight_q_.pop(f)) {
+        tp_.finish(*f);
+        out_q_.push(f);
+    }
+    out_q_.close();
+}
@@ -0,0 +1,266 @@
+#ifndef RADAR_PIPELINE_H
+#define RADAR_PIPELINE_H
+
+#include "radar_defines.h"
+#include <cstdint>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <string>
+
+// ==========================================
+// 主机侧异步流水线驱动 (RadarPipeline)
+// 1. RadarBufferPool  : 构造时一次性分配 (64 字节对齐、尽量 mlock) 的帧缓冲池，运行期零分配
+// 2. RadarQueue       : 固定容量的阻塞环形队列 (输入 / 输出队列，默认深度 2 即双缓冲)
+// 3. RadarTransport   : 可替换的传输层
+//      RadarStreamTransport  : 直接调用 radar_top (C-sim DUT) 或 radar_top_sw (软件后端)
+//      RadarShmDmaTransport  : 共享内存 DMA 模拟器，设备侧可在本进程线程或另一进程中运行
+// 4. RadarPipeline    : submit / wait_complete 异步接口，发起与收尾各一个线程，
+//                       主机填下一帧、传输层计算当前帧、主机取上一帧结果三者重叠
+//
+// 帧输出格式与 radar_top 的输出流一致：FRAME_HDR_WORDS 个帧头字 + N_RANGE*N_PULSE 个 RD 单元，
+// 每个单元为 32 bit ([15:0] 实部, [31:16] 虚部，与 rd_beat_word 相同)
+// ==========================================
+
+#define RADAR_IN_WORDS  (PRESUM_MAX_PULSES * N_RANGE)   // 预积累时输入脉冲数可达 N_PULSE * K
+#define RADAR_OUT_WORDS (FRAME_HDR_WORDS + N_RANGE * N_PULSE)
+
+// 本帧实际输出字数 (选了多普勒子带时每个距离门只有 dop_bins 个单元)
+inline int radar_frame_out_words(radar_ctrl_t ctrl) {
+    return FRAME_HDR_WORDS + N_RANGE * radar_ctrl_dop_bins(ctrl);
+}
+
+// 一帧的输入 / 输出缓冲 (指针指向缓冲池内的固定区域)
+struct RadarFrame {
+    uint64_t      seq;          // 提交序号 (submit 时填写)
+    radar_ctrl_t  ctrl;         // 输出顺序 / 实际脉冲数 / 加窗 / 预积累
+    uint32_t     *in_words;     // [RADAR_IN_WORDS]，前 radar_ctrl_in_pulses 个脉冲有效，打包同 axis_in_t.data
+    uint64_t     *pulse_user;   // [PRESUM_MAX_PULSES] 每个输入脉冲的 TUSER 元数据 (pulse_meta_pack)
+    dop_win_t    *dop_win;      // [N_PULSE] 慢时间窗
+    pc_fir_tap_t *pc_fir_tap;   // [PC_FIR_MAX_TAPS] 短码 FIR 抽头 (ctrl.pc_fir_taps = 0 时不用)
+    uint32_t     *out_words;    // [RADAR_OUT_WORDS] 帧头 + RD 单元 (本帧实际 radar_frame_out_words 个)
+    int           out_count;    // 实际输出字数
+    int           status;       // 0: 成功  <0: 传输错误
+    int           pool_index;   // 缓冲池内序号
+};
+
+// ------------------------------------------
+// 固定容量阻塞队列 (容量在构造时确定，push/pop 不分配内存)
+// close() 后 pop 在队列空时返回 false
+// ------------------------------------------
+template <class T>
+class RadarQueue {
+public:
+    explicit RadarQueue(int capacity) : buf_(capacity), head_(0), count_(0), closed_(false) {}
+
+    void push(const T &v) {
+        std::unique_lock<std::mutex> lk(mtx_);
+        not_full_.wait(lk, [&] { return count_ < (int)buf_.size(); });
+        buf_[(head_ + count_) % buf_.size()] = v;
+        count_++;
+        not_empty_.notify_one();
+    }
+
+    bool pop(T &v) {
+        std::unique_lock<std::mutex> lk(mtx_);
+        not_empty_.wait(lk, [&] { return count_ > 0 || closed_; });
+        if (count_ == 0) return false;
+        take(v);
+        return true;
+    }
+
+    bool try_pop(T &v) {
+        std::lock_guard<std::mutex> lk(mtx_);
+        if (count_ == 0) return false;
+        take(v);
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lk(mtx_);
+        closed_ = true;
+        not_empty_.notify_all();
+    }
+
+    int size() const {
+        std::lock_guard<std::mutex> lk(mtx_);
+        return count_;
+    }
+
+private:
+    void take(T &v) {
+        v = buf_[head_];
+        head_ = (head_ + 1) % (int)buf_.size();
+        count_--;
+        not_full_.notify_one();
+    }
+
+    std::vector<T> buf_;
+    int head_;
+    int count_;
+    bool closed_;
+    mutable std::mutex mtx_;
+    std::condition_variable not_full_, not_empty_;
+};
+
+// ------------------------------------------
+// 帧缓冲池
+// ------------------------------------------
+class RadarBufferPool {
+public:
+    explicit RadarBufferPool(int n_frames);
+    ~RadarBufferPool();
+
+    RadarFrame *acquire();               // 阻塞直到有空闲缓冲；分配失败的池返回 nullptr
+    bool try_acquire(RadarFrame *&f);
+    void release(RadarFrame *f);
+    int size() const { return (int)frames_.size(); }
+    bool locked() const { return locked_; }   // mlock 是否成功 (失败时仍可用，只是可能被换出)
+    bool ok() const { return slab_ != nullptr; }   // 缓冲区分配是否成功 (失败时池为空)
+
+private:
+    RadarBufferPool(const RadarBufferPool &);
+    RadarBufferPool &operator=(const RadarBufferPool &);
+
+    void *slab_;
+    size_t slab_bytes_;
+    bool locked_;
+    std::vector<RadarFrame> frames_;
+    std::vector<dop_win_t> win_;
+    std::vector<pc_fir_tap_t> fir_;
+    RadarQueue<RadarFrame *> free_;
+};
+
+// ------------------------------------------
+// 传输层接口
+// start 发起一帧 (可以立即返回)，finish 等待该帧完成并把结果写回 RadarFrame
+// depth() 为可同时在途的帧数；start/finish 分别只在一个线程中调用，且按相同顺序
+// ------------------------------------------
+class RadarTransport {
+public:
+    virtual ~RadarTransport() {}
+    virtual void start(RadarFrame &f) = 0;
+    virtual void finish(RadarFrame &f) = 0;
+    virtual int depth() const { return 1; }
+    virtual const char *name() const = 0;
+};
+
+// radar_top 与 radar_top_sw 的共同签名
+typedef void (*radar_top_fn_t)(stream_in_t &, stream_rd_t &, radar_ctrl_t, const dop_win_t *,
+                               const pc_fir_tap_t *, ap_uint<32> *, ap_uint<32> *);
+
+// 把一帧打包成 axis 流，调用 fn，再把输出 beat 解包到 f.out_words
+// 帧没有缓冲 (来自分配失败的池) 时不调用 fn，status = -1
+void radar_frame_run(radar_top_fn_t fn, RadarFrame &f);
+
+// C-sim DUT / 软件后端：在 start 中同步计算
+class RadarStreamTransport : public RadarTransport {
+public:
+    explicit RadarStreamTransport(radar_top_fn_t fn = radar_top, const char *name = "csim")
+        : fn_(fn), name_(name) {}
+    void start(RadarFrame &f) { radar_frame_run(fn_, f); }
+    void finish(RadarFrame &) {}
+    const char *name() const { return name_; }
+
+private:
+    radar_top_fn_t fn_;
+    const char *name_;
+};
+
+// ------------------------------------------
+// 共享内存 DMA 模拟器
+// 共享区 = 区头 + n_slots 个槽；每个槽相当于一对 MM2S/S2MM 描述符及其数据缓冲
+// 槽状态：0 空闲 -> 1 主机已提交 (doorbell) -> 2 设备完成 -> 主机取回后回到 0
+// shm_name 为空时使用匿名映射并在本进程内启动设备线程；
+// 非空时创建 POSIX 共享内存，设备可由另一进程用 RadarShmDevice 打开 (spawn_device = false)
+// ------------------------------------------
+struct radar_shm_region_t;
+
+class RadarShmDevice {
+public:
+    // 打开已存在的共享区 (另一进程中使用)
+    RadarShmDevice(const std::string &shm_name, radar_top_fn_t fn);
+    // 服务本进程内的共享区
+    RadarShmDevice(radar_shm_region_t *region, radar_top_fn_t fn);
+    ~RadarShmDevice();
+
+    void run();     // 轮询各槽直到主机置 quit
+    bool ok() const { return region_ != nullptr; }
+
+private:
+    radar_shm_region_t *region_;
+    size_t map_bytes_;
+    bool owns_map_;
+    radar_top_fn_t fn_;
+};
+
+class RadarShmDmaTransport : public RadarTransport {
+public:
+    RadarShmDmaTransport(radar_top_fn_t device_fn = radar_top, int n_slots = 2,
+                         const std::string &shm_name = "", bool spawn_device = true);
+    ~RadarShmDmaTransport();
+
+    void start(RadarFrame &f);
+    void finish(RadarFrame &f);
+    int depth() const { return n_slots_; }
+    const char *name() const { return "shm-dma"; }
+    bool ok() const { return region_ != nullptr; }
+
+private:
+    RadarShmDmaTransport(const RadarShmDmaTransport &);
+    RadarShmDmaTransport &operator=(const RadarShmDmaTransport &);
+
+    radar_shm_region_t *region_;
+    size_t map_bytes_;
+    std::string shm_name_;
+    int n_slots_;
+    uint64_t next_start_, next_finish_;
+    RadarShmDevice *device_;
+    std::thread device_thread_;
+};
+
+// ------------------------------------------
+// 异步流水线
+// 典型用法:
+//   RadarStreamTransport tp(radar_top_sw, "sw");
+//   RadarPipeline pipe(tp);          ... pipe.ok() 为 false 时缓冲池分配失败 ...
+//   RadarFrame *f = pipe.acquire();  ... 填 in_words / pulse_user / ctrl ...
+//   pipe.submit(f);
+//   RadarFrame *done = pipe.wait_complete();  ... 读 out_words ...
+//   pipe.release(done);
+// 完成顺序与提交顺序相同
+// ------------------------------------------
+class RadarPipeline {
+public:
+    RadarPipeline(RadarTransport &tp, int n_buffers = 4, int queue_depth = 2);
+    ~RadarPipeline();
+
+    RadarFrame *acquire() { return pool_.acquire(); }
+    void release(RadarFrame *f) { pool_.release(f); }
+    void submit(RadarFrame *f);               // 输入队列满时阻塞
+    RadarFrame *wait_complete();              // 阻塞直到下一帧完成
+    bool try_complete(RadarFrame *&f);        // 非阻塞
+    int in_flight() const { return submitted_ - completed_; }
+    bool ok() const { return pool_.ok(); }   // 缓冲池分配失败时 acquire 返回 nullptr
+    RadarBufferPool &pool() { return pool_; }
+
+private:
+    RadarPipeline(const RadarPipeline &);
+    RadarPipeline &operator=(const RadarPipeline &);
+
+    void issue_loop();
+    void complete_loop();
+
+    RadarTransport &tp_;
+    RadarBufferPool pool_;
+    RadarQueue<RadarFrame *> in_q_;      // 主机 -> 发起线程
+    RadarQueue<RadarFrame *> flight_q_;  // 发起线程 -> 收尾线程 (容量 = 传输层深度)
+    RadarQueue<RadarFrame *> out_q_;     // 收尾线程 -> 主机
+    std::atomic<int> submitted_, completed_;
+    uint64_t next_seq_;
+    std::thread issue_thread_, complete_thread_;
+};
+
+#endif
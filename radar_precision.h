@@ -0,0 +1,207 @@
+#ifndef RADAR_PRECISION_H
+#define RADAR_PRECISION_H
+
+#include "radar_defines.h"
+#include "radar_fft.h"
+#include "radar_coeffs_gen.h"
+#include <complex>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+// ==========================================
+// 定点位宽探索模型 (仅 C-sim 使用，不参与综合)
+// 与 radar_top 完全相同的处理链，但 adc_t / fft_data_t / coeff_t 的位宽
+// 作为模板参数；FFT 配置随位宽一起实例化
+//   ADC_W   : 输入量化位宽      (radar_defines.h 中为 14)
+//   DATA_W  : 内部数据/角转换位宽 (radar_defines.h 中为 16)
+//   COEFF_W : 匹配滤波系数位宽   (REF_COEFFS 为 dp_complex_t ROM，16 位，双精度直接截断)
+// 默认位宽 (14/16/16) 的实例由 tb_precision_sweep 与 radar_top 逐位比较
+// ==========================================
+
+// 单次运行的溢出统计
+struct prec_stats_t {
+    long fft_ovf;      // 距离向正 FFT 溢出帧数 (status.ovflo)
+    long ifft_ovf;     // 距离向 IFFT 溢出帧数
+    long dop_ovf;      // 多普勒 FFT 溢出帧数
+    long mult_ovf;     // 匹配滤波乘法回绕次数
+    long adc_sat;      // 输入量化饱和次数
+    prec_stats_t() : fft_ovf(0), ifft_ovf(0), dop_ovf(0), mult_ovf(0), adc_sat(0) {}
+};
+
+template <int ADC_W, int DATA_W, int COEFF_W>
+struct radar_prec_model {
+    typedef ap_fixed<ADC_W, 1, AP_RND, AP_SAT> p_adc_t;
+    typedef ap_fixed<DATA_W, 1> p_data_t;
+    typedef ap_fixed<COEFF_W, 1> p_coeff_t;
+    typedef std::complex<p_data_t> p_complex_t;
+
+    struct p_range_config : hls::ip_fft::params_t {
+        static const unsigned input_width  = DATA_W;
+        static const unsigned output_width = DATA_W;
+        static const unsigned max_nfft = fft_config::max_nfft;
+        static const bool     has_nfft = false;
+        static const unsigned config_width = 16;   // 定点、带 sch 字段 (与数据通路选择无关)
+        static const unsigned status_width = 8;
+        static const unsigned ordering_opt = hls::ip_fft::natural_order;
+        static const unsigned arch_opt = hls::ip_fft::pipelined_streaming_io;
+        static const unsigned scaling_opt = hls::ip_fft::scaled;
+    };
+
+    struct p_doppler_config : hls::ip_fft::params_t {
+        static const unsigned input_width  = DATA_W;
+        static const unsigned output_width = DATA_W;
+        static const unsigned max_nfft = doppler_fft_config::max_nfft;
+        static const bool     has_nfft = false;
+        static const unsigned config_width = 16;   // 定点、带 sch 字段 (与数据通路选择无关)
+        static const unsigned status_width = 8;
+        static const unsigned ordering_opt = hls::ip_fft::natural_order;
+        static const unsigned arch_opt = hls::ip_fft::pipelined_streaming_io;
+        static const unsigned scaling_opt = hls::ip_fft::scaled;
+    };
+
+    template <class CFG>
+    static bool run_fft(std::vector<p_complex_t> &x, bool fwd, unsigned sch) {
+        hls::stream<p_complex_t> in, out;
+        hls::stream<hls::ip_fft::config_t<CFG> > cfg_s;
+        hls::stream<hls::ip_fft::status_t<CFG> > sts_s;
+        hls::ip_fft::config_t<CFG> cfg;
+        cfg.setDir(fwd);
+        cfg.setSch(sch);
+        cfg_s.write(cfg);
+        for (size_t i = 0; i < x.size(); i++) in.write(x[i]);
+        radar_fft<CFG>(in, out, sts_s, cfg_s);
+        for (size_t i = 0; i < x.size(); i++) x[i] = out.read();
+        return sts_s.read().getOvflo() != 0;
+    }
+
+    // 角转换块浮点压缩 (与 radar_top.cpp 的 CT_COMPRESS 路径逐位一致)
+    // 整个脉冲共享左移位数 e，尾数 mant_bits 位 (RND + SAT)，解压时算术右移 e
+    static void ct_bfp_pulse(p_complex_t *x, int mant_bits) {
+        const double lsb = std::ldexp(1.0, DATA_W - 1);
+        long mag_or = 0;
+        for (int r = 0; r < N_RANGE; r++) {
+            long re = (long)(x[r].real().to_double() * lsb);
+            long im = (long)(x[r].imag().to_double() * lsb);
+            mag_or |= (re < 0 ? ~re : re) | (im < 0 ? ~im : im);
+        }
+        int e = DATA_W - 1;
+        for (int b = 0; b < DATA_W - 1; b++) {
+            if ((mag_or >> b) & 1) e = DATA_W - 2 - b;
+        }
+        const double m_scale = std::ldexp(1.0, mant_bits - 1);
+        const double m_max = m_scale - 1.0;
+        for (int r = 0; r < N_RANGE; r++) {
+            double v[2] = { x[r].real().to_double(), x[r].imag().to_double() };
+            for (int k = 0; k < 2; k++) {
+                double m = std::floor(std::ldexp(v[k], e) * m_scale + 0.5);
+                m = std::max(-m_scale, std::min(m_max, m));
+                long raw = (long)m << (DATA_W - mant_bits);
+                v[k] = (double)(raw >> e) / lsb;
+            }
+            x[r] = p_complex_t((p_data_t)v[0], (p_data_t)v[1]);
+        }
+    }
+
+    // 输入：N_PULSE*N_RANGE 个 axis_in_t 打包字
+    // 输出：距离优先 RD 图 (与 radar_top 顺序一致)
+    // dop_sch：多普勒 FFT 缩放调度，默认与 doppler_est.cpp 相同
+    // ct_mant：角转换压缩尾数位宽，0 表示不压缩
+    static void run_frame(const uint32_t *in_words, std::complex<double> *out, prec_stats_t &st,
+                          unsigned dop_sch = DOP_FFT_SCH, int ct_mant = 0) {
+        std::vector<p_complex_t> coef(N_RANGE);
+        for (int i = 0; i < N_RANGE; i++) {
+            coef[i] = p_complex_t((p_data_t)p_coeff_t(RADAR_MF_TABLE.re[i]),
+                                  (p_data_t)p_coeff_t(RADAR_MF_TABLE.im[i]));
+        }
+
+        std::vector<p_complex_t> matrix(N_PULSE * N_RANGE);
+        std::vector<p_complex_t> x(N_RANGE);
+        const double full = (double)(1 << (ADC_BITS - 1));
+        const double adc_max = 1.0 - std::ldexp(1.0, -(ADC_W - 1));
+
+        for (int p = 0; p < N_PULSE; p++) {
+            for (int r = 0; r < N_RANGE; r++) {
+                ap_uint<32> w = in_words[p * N_RANGE + r];
+                ap_int<14> raw_re = w.range(13, 0);
+                ap_int<14> raw_im = w.range(29, 16);
+                double vr = raw_re.to_double() / full, vi = raw_im.to_double() / full;
+                if (vr > adc_max || vi > adc_max) st.adc_sat++;
+                x[r] = p_complex_t((p_data_t)p_adc_t(vr), (p_data_t)p_adc_t(vi));
+            }
+            if (run_fft<p_range_config>(x, true, PC_FFT_SCH)) st.fft_ovf++;
+            for (int r = 0; r < N_RANGE; r++) {
+                double ar = x[r].real().to_double(), ai = x[r].imag().to_double();
+                double br = coef[r].real().to_double(), bi = coef[r].imag().to_double();
+                double pr = ar * br - ai * bi, pi = ar * bi + ai * br;
+                if (pr >= 1.0 || pr < -1.0 || pi >= 1.0 || pi < -1.0) st.mult_ovf++;
+                x[r] = x[r] * coef[r];
+            }
+            if (run_fft<p_range_config>(x, false, PC_IFFT_SCH)) st.ifft_ovf++;
+            if (ct_mant > 0) ct_bfp_pulse(x.data(), ct_mant);
+            for (int r = 0; r < N_RANGE; r++) matrix[p * N_RANGE + r] = x[r];
+        }
+
+        std::vector<p_complex_t> col(N_PULSE);
+        for (int r = 0; r < N_RANGE; r++) {
+            for (int p = 0; p < N_PULSE; p++) col[p] = matrix[p * N_RANGE + r];
+            if (run_fft<p_doppler_config>(col, true, dop_sch)) st.dop_ovf++;
+            for (int d = 0; d < N_PULSE; d++) {
+                out[r * N_PULSE + d] = std::complex<double>(col[d].real().to_double(),
+                                                            col[d].imag().to_double());
+            }
+        }
+    }
+};
+
+// ==========================================
+// 双精度参考 (相同的缩放，无量化)
+// ==========================================
+static inline void prec_reference_frame(const uint32_t *in_words, std::complex<double> *out,
+                                        unsigned dop_sch = DOP_FFT_SCH) {
+    const int lr = fft_config::max_nfft;
+    const int ld = doppler_fft_config::max_nfft;
+    const double s_fwd = std::ldexp(1.0, -fft_sch_shift(PC_FFT_SCH, lr));
+    const double s_inv = std::ldexp(1.0, -fft_sch_shift(PC_IFFT_SCH, lr));
+    const double s_dop = std::ldexp(1.0, -fft_sch_shift(dop_sch, ld));
+    const double full = (double)(1 << (ADC_BITS - 1));
+
+    std::vector<coeff_gen::table_t<N_RANGE> > pc(N_PULSE);
+    for (int p = 0; p < N_PULSE; p++) {
+        coeff_gen::table_t<N_RANGE> &x = pc[p];
+        for (int r = 0; r < N_RANGE; r++) {
+            ap_uint<32> w = in_words[p * N_RANGE + r];
+            ap_int<14> raw_re = w.range(13, 0);
+            ap_int<14> raw_im = w.range(29, 16);
+            x.re[r] = raw_re.to_double() / full;
+            x.im[r] = raw_im.to_double() / full;
+        }
+        coeff_gen::fft<N_RANGE>(x);
+        for (int r = 0; r < N_RANGE; r++) {
+            double ar = x.re[r] * s_fwd, ai = x.im[r] * s_fwd;
+            double br = RADAR_MF_TABLE.re[r], bi = RADAR_MF_TABLE.im[r];
+            // IFFT(y) = conj(FFT(conj(y)))
+            x.re[r] = ar * br - ai * bi;
+            x.im[r] = -(ar * bi + ai * br);
+        }
+        coeff_gen::fft<N_RANGE>(x);
+        for (int r = 0; r < N_RANGE; r++) {
+            x.re[r] = x.re[r] * s_inv;
+            x.im[r] = -x.im[r] * s_inv;
+        }
+    }
+
+    coeff_gen::table_t<N_PULSE> col;
+    for (int r = 0; r < N_RANGE; r++) {
+        for (int p = 0; p < N_PULSE; p++) {
+            col.re[p] = pc[p].re[r];
+            col.im[p] = pc[p].im[r];
+        }
+        coeff_gen::fft<N_PULSE>(col);
+        for (int d = 0; d < N_PULSE; d++) {
+            out[r * N_PULSE + d] = std::complex<double>(col.re[d] * s_dop, col.im[d] * s_dop);
+        }
+    }
+}
+
+#endif
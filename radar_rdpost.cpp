@@ -0,0 +1,366 @@
+#include "radar_rdpost.h"
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// ==========================================================================
+// 1. 标量辅助 (向量版本逐条对应，尾部与无 AVX2 时使用)
+// ==========================================================================
+static const float RDPOST_CELL_SCALE = 1.0f / 32768.0f;
+static const float RDPOST_DB_PER_LOG2 = 3.01029996f;   // 10 * log10(2)
+
+// log2(1 + t)，t 在 [0, 1)：切比雪夫节点插值，最大误差 1.7e-5 (约 5e-5 dB)
+static const float LOG2_C0 = 1.65146709e-05f;
+static const float LOG2_C1 = 1.44149241f;
+static const float LOG2_C2 = -0.706486449f;
+static const float LOG2_C3 = 0.409470299f;
+static const float LOG2_C4 = -0.187488605f;
+static const float LOG2_C5 = 0.0430049578f;
+
+static inline float cell_re(uint32_t w) { return (float)(int16_t)(w & 0xFFFF) * RDPOST_CELL_SCALE; }
+static inline float cell_im(uint32_t w) { return (float)(int16_t)(w >> 16) * RDPOST_CELL_SCALE; }
+
+static inline float fast_log2(float x) {
+    uint32_t b;
+    memcpy(&b, &x, 4);
+    float e = (float)((int32_t)(b >> 23) - 127);
+    uint32_t mb = (b & 0x7FFFFF) | 0x3F800000;
+    float m;
+    memcpy(&m, &mb, 4);
+    float t = m - 1.0f;
+    float p = LOG2_C5;
+    p = p * t + LOG2_C4;
+    p = p * t + LOG2_C3;
+    p = p * t + LOG2_C2;
+    p = p * t + LOG2_C1;
+    p = p * t + LOG2_C0;
+    return e + p;
+}
+
+static inline float quant_clamp(float v) {
+    return v < 0.0f ? 0.0f : (v > 255.0f ? 255.0f : v);
+}
+
+// ==========================================================================
+// 2. 单元内核
+// ==========================================================================
+#if defined(__AVX2__)
+static inline void v_unpack(const uint32_t *p, __m256 &re, __m256 &im) {
+    const __m256 sc = _mm256_set1_ps(RDPOST_CELL_SCALE);
+    __m256i w = _mm256_loadu_si256((const __m256i *)p);
+    re = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_slli_epi32(w, 16), 16)), sc);
+    im = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srai_epi32(w, 16)), sc);
+}
+
+static inline __m256 v_log2(__m256 x) {
+    __m256i b = _mm256_castps_si256(x);
+    __m256 e = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(b, 23), _mm256_set1_epi32(127)));
+    __m256i mb = _mm256_or_si256(_mm256_and_si256(b, _mm256_set1_epi32(0x7FFFFF)), _mm256_set1_epi32(0x3F800000));
+    __m256 t = _mm256_sub_ps(_mm256_castsi256_ps(mb), _mm256_set1_ps(1.0f));
+    __m256 p = _mm256_set1_ps(LOG2_C5);
+    p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(LOG2_C4));
+    p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(LOG2_C3));
+    p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(LOG2_C2));
+    p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(LOG2_C1));
+    p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(LOG2_C0));
+    return _mm256_add_ps(e, p);
+}
+#endif
+
+void rdpost_power(const uint32_t *cells, float *pow, int n) {
+    int i = 0;
+#if defined(__AVX2__)
+    for (; i + 8 <= n; i += 8) {
+        __m256 re, im;
+        v_unpack(cells + i, re, im);
+        _mm256_storeu_ps(pow + i, _mm256_add_ps(_mm256_mul_ps(re, re), _mm256_mul_ps(im, im)));
+    }
+#endif
+    for (; i < n; i++) {
+        float re = cell_re(cells[i]), im = cell_im(cells[i]);
+        pow[i] = re * re + im * im;
+    }
+}
+
+void rdpost_mag(const uint32_t *cells, float *mag, int n) {
+    int i = 0;
+#if defined(__AVX2__)
+    for (; i + 8 <= n; i += 8) {
+        __m256 re, im;
+        v_unpack(cells + i, re, im);
+        _mm256_storeu_ps(mag + i, _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(re, re), _mm256_mul_ps(im, im))));
+    }
+#endif
+    for (; i < n; i++) {
+        float re = cell_re(cells[i]), im = cell_im(cells[i]);
+        mag[i] = std::sqrt(re * re + im * im);
+    }
+}
+
+void rdpost_db(const float *pow, float *db, int n) {
+    int i = 0;
+#if defined(__AVX2__)
+    const __m256 k = _mm256_set1_ps(RDPOST_DB_PER_LOG2);
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(db + i, _mm256_mul_ps(v_log2(_mm256_loadu_ps(pow + i)), k));
+    }
+#endif
+    for (; i < n; i++) db[i] = fast_log2(pow[i]) * RDPOST_DB_PER_LOG2;
+}
+
+void rdpost_quant8(const float *db, uint8_t *pix, int n, float lo_db, float span_db) {
+    const float g = 255.0f / span_db;
+    int i = 0;
+#if defined(__AVX2__)
+    const __m256 vlo = _mm256_set1_ps(lo_db), vg = _mm256_set1_ps(g);
+    const __m256 v0 = _mm256_setzero_ps(), v255 = _mm256_set1_ps(255.0f);
+    for (; i + 8 <= n; i += 8) {
+        __m256 v = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(db + i), vlo), vg);
+        v = _mm256_min_ps(_mm256_max_ps(v, v0), v255);
+        // 取整 (就近) 后 32 -> 16 -> 8 位：pack 在每个 128 位通道内进行，低 4 字节即本通道 4 个像素
+        __m256i q = _mm256_cvtps_epi32(v);
+        __m256i q8 = _mm256_packus_epi16(_mm256_packs_epi32(q, q), _mm256_setzero_si256());
+        int lo4 = _mm_cvtsi128_si32(_mm256_castsi256_si128(q8));
+        int hi4 = _mm_cvtsi128_si32(_mm256_extracti128_si256(q8, 1));
+        memcpy(pix + i, &lo4, 4);
+        memcpy(pix + i + 4, &hi4, 4);
+    }
+#endif
+    for (; i < n; i++) pix[i] = (uint8_t)std::lrint(quant_clamp((db[i] - lo_db) * g));
+}
+
+// ==========================================================================
+// 3. 每帧统计
+// ==========================================================================
+// 直方图：[-128, +8) dB，0.25 dB 一格，更低的 (含功率为 0) 计入第 0 格
+static const float HIST_LO_DB = -128.0f;
+static const int HIST_PER_DB = 4;
+static const int HIST_BINS = 136 * HIST_PER_DB;
+// 复高斯噪声的单元功率服从指数分布：均值 = 中位数 / ln2，即 +1.59 dB
+static const float EXP_MEAN_OVER_MEDIAN_DB = 1.59160f;
+
+float rdpost_noise_floor_db(const float *db, int n) {
+    int hist[HIST_BINS];
+    memset(hist, 0, sizeof(hist));
+    for (int i = 0; i < n; i++) {
+        int b = (int)((db[i] - HIST_LO_DB) * HIST_PER_DB);
+        b = b < 0 ? 0 : (b >= HIST_BINS ? HIST_BINS - 1 : b);
+        hist[b]++;
+    }
+    // 中位数：累计到一半的格，格内线性插值
+    const float half = 0.5f * n;
+    int acc = 0;
+    for (int b = 0; b < HIST_BINS; b++) {
+        if (acc + hist[b] >= half) {
+            float frac = hist[b] ? (half - acc) / hist[b] : 0.0f;
+            return HIST_LO_DB + (b + frac) / HIST_PER_DB + EXP_MEAN_OVER_MEDIAN_DB;
+        }
+        acc += hist[b];
+    }
+    return HIST_LO_DB + HIST_BINS / HIST_PER_DB;
+}
+
+// 候选峰值按功率降序插入 (top_k 很小，插入排序即可)
+static void peak_insert(float p, int row, int col, int top_k, int &n, float *pw, int *pr, int *pc) {
+    if (n == top_k && p <= pw[n - 1]) return;
+    int k = (n < top_k) ? n++ : n - 1;
+    while (k > 0 && pw[k - 1] < p) {
+        pw[k] = pw[k - 1];
+        pr[k] = pr[k - 1];
+        pc[k] = pc[k - 1];
+        k--;
+    }
+    pw[k] = p;
+    pr[k] = row;
+    pc[k] = col;
+}
+
+int rdpost_peaks(const float *pow, const rd_map_desc_t &d, float thresh, int top_k, rd_peak_t *out) {
+    if (top_k > RDPOST_MAX_PEAKS) top_k = RDPOST_MAX_PEAKS;
+    if (top_k <= 0) return 0;
+    const int rows = d.dop_major ? d.n_bins : d.n_range;
+    const int cols = d.dop_major ? d.n_range : d.n_bins;
+    // 完整多普勒轴首尾相接；子带两端与距离轴两端只比较存在的相邻单元
+    const bool wrap = (d.n_bins == N_PULSE);
+    const bool wrap_rows = wrap && d.dop_major;
+    const bool wrap_cols = wrap && !d.dop_major;
+
+    float pw[RDPOST_MAX_PEAKS];
+    int pr[RDPOST_MAX_PEAKS], pc[RDPOST_MAX_PEAKS];
+    int n = 0;
+
+    // 相等时只保留左 / 上的那个 (右、下用 >=)
+    auto check = [&](int r, int c) {
+        const float *row = pow + (size_t)r * cols;
+        float p = row[c];
+        if (c > 0 || wrap_cols) {
+            if (!(p > row[c > 0 ? c - 1 : cols - 1])) return;
+        }
+        if (c < cols - 1 || wrap_cols) {
+            if (!(p >= row[c < cols - 1 ? c + 1 : 0])) return;
+        }
+        if (r > 0 || wrap_rows) {
+            if (!(p > pow[(size_t)(r > 0 ? r - 1 : rows - 1) * cols + c])) return;
+        }
+        if (r < rows - 1 || wrap_rows) {
+            if (!(p >= pow[(size_t)(r < rows - 1 ? r + 1 : 0) * cols + c])) return;
+        }
+        peak_insert(p, r, c, top_k, n, pw, pr, pc);
+    };
+
+    for (int r = 0; r < rows; r++) {
+        const float *row = pow + (size_t)r * cols;
+        int c = 0;
+#if defined(__AVX2__)
+        // 绝大多数单元低于门限：一次比较 8 个，全部低于时整块跳过
+        const __m256 vt = _mm256_set1_ps(thresh);
+        for (; c + 8 <= cols; c += 8) {
+            int m = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(row + c), vt, _CMP_GT_OQ));
+            while (m) {
+                int k = __builtin_ctz(m);
+                m &= m - 1;
+                check(r, c + k);
+            }
+        }
+#endif
+        for (; c < cols; c++) {
+            if (row[c] > thresh) check(r, c);
+        }
+    }
+
+    for (int k = 0; k < n; k++) {
+        int j = d.dop_major ? pr[k] : pc[k];
+        int pos = (d.dop_first + j) % N_PULSE;
+        out[k].range = d.dop_major ? pc[k] : pr[k];
+        out[k].dop = d.dop_shift ? pos - N_PULSE / 2 : pos;
+        out[k].pow_db = 10.0f * std::log10(pw[k]);
+    }
+    return n;
+}
+
+bool rdpost_parse_header(const uint32_t *frame, rd_map_desc_t &d) {
+    if (frame[0] != FRAME_HDR_MAGIC || (frame[1] & 0xFFFF) != FRAME_HDR_VERSION) return false;
+    if ((frame[3] >> 16) != N_PULSE) return false;
+    d.hdr_words = frame[1] >> 16;
+    d.frame_cnt = frame[2];
+    d.n_range = frame[3] & 0xFFFF;
+    d.dop_major = (frame[7] >> 8) & 1;
+    d.dop_shift = (frame[7] >> 9) & 1;
+    d.dop_first = frame[8] & 0xFFFF;
+    d.n_bins = frame[8] >> 16;
+    return d.n_range > 0 && d.n_bins > 0 && d.n_bins <= N_PULSE && d.n_range * d.n_bins <= RDPOST_MAX_CELLS;
+}
+
+// ==========================================================================
+// 4. 线程池与逐帧处理
+// ==========================================================================
+static float *rdpost_alloc(size_t n) {
+    void *p = nullptr;
+    if (posix_memalign(&p, 64, n * sizeof(float)) != 0) return nullptr;
+    return (float *)p;
+}
+
+RadarRdPost::RadarRdPost(const rdpost_cfg_t &cfg, int n_threads)
+    : cfg_(cfg), job_gen_(0), job_pending_(0), quit_(false),
+      batch_frames_(nullptr), batch_res_(nullptr), batch_pixels_(nullptr), batch_n_(0), batch_next_(0) {
+    if (n_threads <= 0) n_threads = (int)std::thread::hardware_concurrency();
+    if (n_threads <= 0) n_threads = 1;
+    if (cfg_.top_k > RDPOST_MAX_PEAKS) cfg_.top_k = RDPOST_MAX_PEAKS;
+
+    work_.resize(n_threads);
+    for (int i = 0; i < n_threads; i++) {
+        work_[i].pow = rdpost_alloc(RDPOST_MAX_CELLS);
+        work_[i].db = rdpost_alloc(RDPOST_MAX_CELLS);
+    }
+    for (int i = 1; i < n_threads; i++) {
+        workers_.push_back(std::thread(&RadarRdPost::worker_loop, this, i));
+    }
+}
+
+RadarRdPost::~RadarRdPost() {
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        quit_ = true;
+    }
+    cv_start_.notify_all();
+    for (size_t i = 0; i < workers_.size(); i++) workers_[i].join();
+    for (size_t i = 0; i < work_.size(); i++) {
+        free(work_[i].pow);
+        free(work_[i].db);
+    }
+}
+
+void RadarRdPost::frame(const uint32_t *frame, rdpost_result_t &res, uint8_t *pixels, work_t &w) {
+    res.n_peaks = 0;
+    res.noise_db = 0.0f;
+    if (!rdpost_parse_header(frame, res.desc)) {
+        res.status = -1;
+        return;
+    }
+    const int n = res.desc.n_range * res.desc.n_bins;
+    const uint32_t *cells = frame + res.desc.hdr_words;
+
+    rdpost_power(cells, w.pow, n);
+    rdpost_db(w.pow, w.db, n);
+    res.noise_db = rdpost_noise_floor_db(w.db, n);
+    const float thresh = std::pow(10.0f, 0.1f * (res.noise_db + cfg_.peak_snr_db));
+    res.n_peaks = rdpost_peaks(w.pow, res.desc, thresh, cfg_.top_k, res.peaks);
+    if (pixels) rdpost_quant8(w.db, pixels, n, res.noise_db + cfg_.disp_floor_db, cfg_.disp_span_db);
+    res.status = 0;
+}
+
+void RadarRdPost::process_one(const uint32_t *frame_words, rdpost_result_t &res, uint8_t *pixels) {
+    frame(frame_words, res, pixels, work_[0]);
+}
+
+void RadarRdPost::run_batch(int id) {
+    for (;;) {
+        int i = batch_next_.fetch_add(1);
+        if (i >= batch_n_) return;
+        frame(batch_frames_[i], batch_res_[i], batch_pixels_ ? batch_pixels_[i] : nullptr, work_[id]);
+    }
+}
+
+void RadarRdPost::worker_loop(int id) {
+    int seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lk(mtx_);
+            cv_start_.wait(lk, [&] { return quit_ || job_gen_ != seen; });
+            if (quit_) return;
+            seen = job_gen_;
+        }
+        run_batch(id);
+        {
+            std::lock_guard<std::mutex> lk(mtx_);
+            if (--job_pending_ == 0) cv_done_.notify_one();
+        }
+    }
+}
+
+void RadarRdPost::process(const uint32_t *const *frames, int n_frames, rdpost_result_t *res,
+                          uint8_t *const *pixels) {
+    batch_frames_ = frames;
+    batch_res_ = res;
+    batch_pixels_ = pixels;
+    batch_n_ = n_frames;
+    batch_next_ = 0;
+    // 只有一帧时不唤醒工作线程
+    if (workers_.empty() || n_frames <= 1) {
+        run_batch(0);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        job_pending_ = (int)workers_.size();
+        job_gen_++;
+    }
+    cv_start_.notify_all();
+    run_batch(0);
+    std::unique_lock<std::mutex> lk(mtx_);
+    cv_done_.wait(lk, [&] { return job_pending_ == 0; });
+}
@@ -0,0 +1,116 @@
+#ifndef RADAR_RDPOST_H
+#define RADAR_RDPOST_H
+
+#include "radar_defines.h"
+#include <cstdint>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+// ==========================================
+// 主机侧 RD 图后处理 (实时显示 / 快速反应逻辑)，代替 gen_plot_2d.py 与显示程序中逐单元的标量运算
+// 输入为 radar_top 的一帧 (RadarFrame.out_words：帧头 + RD 单元)，单元打包与 rd_beat_word 相同
+//   [15:0] 实部, [31:16] 虚部，16 位补码，满幅 32768 对应 1.0；功率与 dB 均以满幅为 0 dB (dBFS)
+// 1. 单元内核 (AVX2 / 标量，按编译选项选择，同 radar_sw.cpp)：
+//      |x|^2、|x|、快速 dB (指数位 + 5 阶多项式，误差 < 1e-4 dB)、8 位显示量化
+// 2. 每帧统计：噪声底 (dB 直方图中位数，按复高斯噪声换算为平均功率)、前 K 个峰值 (局部极大且超过门限)
+// 3. RadarRdPost：常驻线程池，一批帧按帧分给各线程，帧内不拆分 (线程之间只共享一个帧计数器)
+// ==========================================
+
+#define RDPOST_MAX_PEAKS 32
+#define RDPOST_MAX_CELLS (N_RANGE * N_PULSE)
+
+// 由帧头解析出的 RD 图尺寸与顺序
+struct rd_map_desc_t {
+    int      hdr_words;   // RD 单元在帧内的起始字
+    int      n_range;
+    int      n_bins;      // 每个距离门的多普勒单元数 (选了子带时为 dop_bins)
+    int      dop_first;   // 第一个单元在多普勒输出轴上的位置
+    bool     dop_major;   // true: 单元按 [bin][range] 排列，否则 [range][bin]
+    bool     dop_shift;   // 多普勒输出轴已 fftshift
+    uint32_t frame_cnt;
+};
+
+struct rd_peak_t {
+    int   range;
+    int   dop;        // 多普勒 bin：dop_shift 时为 [-N_PULSE/2, N_PULSE/2)，否则 [0, N_PULSE)
+    float pow_db;
+};
+
+struct rdpost_cfg_t {
+    int   top_k;          // 每帧最多报告的峰值数 (<= RDPOST_MAX_PEAKS)
+    float peak_snr_db;    // 峰值门限：噪声底以上多少 dB
+    float disp_floor_db;  // 显示下限 = 噪声底 + disp_floor_db (通常为负)
+    float disp_span_db;   // 显示动态范围：像素 0..255 对应 [下限, 下限 + disp_span_db]
+};
+
+struct rdpost_result_t {
+    int           status;     // 0: 成功  <0: 帧头错误
+    rd_map_desc_t desc;
+    float         noise_db;   // 每单元平均噪声功率 (dBFS)
+    int           n_peaks;
+    rd_peak_t     peaks[RDPOST_MAX_PEAKS];   // 按功率降序
+};
+
+// 帧头检查与解析 (magic / 版本 / 尺寸)，失败返回 false
+bool rdpost_parse_header(const uint32_t *frame, rd_map_desc_t &d);
+
+// 单元内核：n 任意，不足一个向量的尾部按标量处理，结果与向量部分逐位相同
+void rdpost_power(const uint32_t *cells, float *pow, int n);
+void rdpost_mag(const uint32_t *cells, float *mag, int n);
+void rdpost_db(const float *pow, float *db, int n);          // 10*log10(pow)，pow = 0 时约 -382 dB
+void rdpost_quant8(const float *db, uint8_t *pix, int n, float lo_db, float span_db);
+
+// 噪声底：db 为 n 个单元的功率 dB，返回每单元平均噪声功率 (dBFS)
+float rdpost_noise_floor_db(const float *db, int n);
+// 峰值扫描：功率超过 thresh 且不小于上下左右相邻单元 (完整多普勒轴按循环处理)，返回找到的个数 (<= top_k)
+int rdpost_peaks(const float *pow, const rd_map_desc_t &d, float thresh, int top_k, rd_peak_t *out);
+
+class RadarRdPost {
+public:
+    // n_threads <= 0 时使用硬件线程数
+    explicit RadarRdPost(const rdpost_cfg_t &cfg, int n_threads = 0);
+    ~RadarRdPost();
+
+    // 一批帧，各帧互相独立地分给线程池；pixels 可为 nullptr (不做显示量化)，
+    // 否则 pixels[i] 至少 n_range * n_bins 字节，顺序与该帧的单元相同
+    void process(const uint32_t *const *frames, int n_frames, rdpost_result_t *res, uint8_t *const *pixels);
+
+    // 单帧，在调用线程内完成 (使用第 0 个线程的工作区，不能与 process 并发)
+    void process_one(const uint32_t *frame, rdpost_result_t &res, uint8_t *pixels);
+
+    int threads() const { return (int)workers_.size() + 1; }
+
+private:
+    RadarRdPost(const RadarRdPost &);
+    RadarRdPost &operator=(const RadarRdPost &);
+
+    struct work_t {
+        float *pow;   // [RDPOST_MAX_CELLS]
+        float *db;    // [RDPOST_MAX_CELLS]
+    };
+
+    void frame(const uint32_t *frame, rdpost_result_t &res, uint8_t *pixels, work_t &w);
+    void run_batch(int id);
+    void worker_loop(int id);
+
+    rdpost_cfg_t cfg_;
+    std::vector<work_t> work_;
+    std::vector<std::thread> workers_;
+    std::mutex mtx_;
+    std::condition_variable cv_start_, cv_done_;
+    int job_gen_;
+    int job_pending_;
+    bool quit_;
+
+    // 当前批次
+    const uint32_t *const *batch_frames_;
+    rdpost_result_t *batch_res_;
+    uint8_t *const *batch_pixels_;
+    int batch_n_;
+    std::atomic<int> batch_next_;
+};
+
+#endif
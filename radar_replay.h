@@ -0,0 +1,54 @@
+#ifndef RADAR_REPLAY_H
+#define RADAR_REPLAY_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+// ==========================================
+// 回放 / 激励二进制格式 (小端)
+// [文件头 32 字节] + n_frames * n_pulse * n_range 个 32bit 字
+// 每个字的打包与 axis_in_t.data 完全一致：
+//   [13:0] 实部，[29:16] 虚部，14 位补码
+// ==========================================
+#define RADAR_REPLAY_MAGIC   "RDRP"
+#define RADAR_REPLAY_VERSION 1
+
+struct radar_replay_hdr_t {
+    char     magic[4];
+    uint32_t version;
+    uint32_t n_range;
+    uint32_t n_pulse;
+    uint32_t n_frames;
+    uint32_t word_bytes;   // 固定为 4
+    uint32_t reserved[2];
+};
+
+static inline uint32_t radar_pack_iq(int re, int im) {
+    return ((uint32_t)re & 0x3FFF) | (((uint32_t)im & 0x3FFF) << 16);
+}
+
+static inline void radar_unpack_iq(uint32_t w, int &re, int &im) {
+    re = (int32_t)(w << 18) >> 18;
+    im = (int32_t)(w << 2) >> 18;
+}
+
+static inline bool radar_replay_write_header(FILE *fp, uint32_t n_range, uint32_t n_pulse,
+                                             uint32_t n_frames) {
+    radar_replay_hdr_t h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, RADAR_REPLAY_MAGIC, 4);
+    h.version = RADAR_REPLAY_VERSION;
+    h.n_range = n_range;
+    h.n_pulse = n_pulse;
+    h.n_frames = n_frames;
+    h.word_bytes = 4;
+    return fwrite(&h, sizeof(h), 1, fp) == 1;
+}
+
+static inline bool radar_replay_read_header(FILE *fp, radar_replay_hdr_t &h) {
+    if (fread(&h, sizeof(h), 1, fp) != 1) return false;
+    return memcmp(h.magic, RADAR_REPLAY_MAGIC, 4) == 0 && h.word_bytes == 4;
+}
+
+#endif
@@ -0,0 +1,484 @@
+#include "radar_sw.h"
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// ==========================================================================
+// 0. 系数 (与 pulse_compression.cpp 同源)
+// ==========================================================================
+#if defined(RADAR_COEFFS_FROM_FILE)
+    static const float SW_REF_COEFFS[N_RANGE][2] = {
+        #include "radar_coeffs.h"
+    };
+    #define SW_REF_RE(i) SW_REF_COEFFS[i][0]
+    #define SW_REF_IM(i) SW_REF_COEFFS[i][1]
+#else
+    #include "radar_coeffs_gen.h"
+    #define SW_REF_RE(i) ((float)RADAR_MF_TABLE.re[i])
+    #define SW_REF_IM(i) ((float)RADAR_MF_TABLE.im[i])
+#endif
+
+static_assert((N_RANGE & (N_RANGE - 1)) == 0, "N_RANGE must be a power of 2");
+static_assert((N_PULSE & (N_PULSE - 1)) == 0, "N_PULSE must be a power of 2");
+
+static int sw_log2(int n) {
+    int l = 0;
+    while ((1 << l) < n) l++;
+    return l;
+}
+
+// ==========================================================================
+// 1. SIMD 抽象 (AVX-512 / AVX2 / 标量)
+// ==========================================================================
+#if defined(__AVX512F__)
+    typedef __m512 vf_t;
+    #define SW_VW 16
+    static inline vf_t v_ld(const float *p) { return _mm512_loadu_ps(p); }
+    static inline void v_st(float *p, vf_t a) { _mm512_storeu_ps(p, a); }
+    static inline vf_t v_add(vf_t a, vf_t b) { return _mm512_add_ps(a, b); }
+    static inline vf_t v_sub(vf_t a, vf_t b) { return _mm512_sub_ps(a, b); }
+    static inline vf_t v_mul(vf_t a, vf_t b) { return _mm512_mul_ps(a, b); }
+    static inline vf_t v_fma(vf_t a, vf_t b, vf_t c) { return _mm512_fmadd_ps(a, b, c); }
+    static inline vf_t v_fms(vf_t a, vf_t b, vf_t c) { return _mm512_fmsub_ps(a, b, c); }
+#elif defined(__AVX2__)
+    typedef __m256 vf_t;
+    #define SW_VW 8
+    static inline vf_t v_ld(const float *p) { return _mm256_loadu_ps(p); }
+    static inline void v_st(float *p, vf_t a) { _mm256_storeu_ps(p, a); }
+    static inline vf_t v_add(vf_t a, vf_t b) { return _mm256_add_ps(a, b); }
+    static inline vf_t v_sub(vf_t a, vf_t b) { return _mm256_sub_ps(a, b); }
+    static inline vf_t v_mul(vf_t a, vf_t b) { return _mm256_mul_ps(a, b); }
+  #if defined(__FMA__)
+    static inline vf_t v_fma(vf_t a, vf_t b, vf_t c) { return _mm256_fmadd_ps(a, b, c); }
+    static inline vf_t v_fms(vf_t a, vf_t b, vf_t c) { return _mm256_fmsub_ps(a, b, c); }
+  #else
+    static inline vf_t v_fma(vf_t a, vf_t b, vf_t c) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+    static inline vf_t v_fms(vf_t a, vf_t b, vf_t c) { return _mm256_sub_ps(_mm256_mul_ps(a, b), c); }
+  #endif
+#else
+    #define SW_VW 1
+#endif
+
+// ==========================================================================
+// 2. FFT 计划 (实虚分离, radix-2)
+// 正变换用 DIF (自然序入 -> 位反序出)，逆变换用 DIT (位反序入 -> 自然序出)
+// 这样频域相乘在位反序下完成，整个脉压不需要任何重排
+// twiddle 表按级拼接：半跨度 h 的级使用 tw[h .. 2h-1]
+// ==========================================================================
+struct sw_fft_plan {
+    int n;
+    int log2n;
+    std::vector<float> tw_re, tw_im;   // exp(-j*2*pi*k/(2h))
+    std::vector<float> tw_im_conj;     // 逆变换用 (虚部取反)
+    std::vector<int> bitrev;
+
+    explicit sw_fft_plan(int n_)
+        : n(n_), log2n(sw_log2(n_)), tw_re(n_), tw_im(n_), tw_im_conj(n_), bitrev(n_) {
+        for (int h = 1; h < n; h <<= 1) {
+            for (int k = 0; k < h; k++) {
+                double a = -M_PI * k / h;
+                tw_re[h + k] = (float)std::cos(a);
+                tw_im[h + k] = (float)std::sin(a);
+                tw_im_conj[h + k] = -tw_im[h + k];
+            }
+        }
+        for (int i = 0; i < n; i++) {
+            int r = 0;
+            for (int b = 0; b < log2n; b++) r |= ((i >> b) & 1) << (log2n - 1 - b);
+            bitrev[i] = r;
+        }
+    }
+};
+
+// 单个蝶形级 (DIF: 先加减后乘旋转因子；DIT: 先乘后加减)
+// conj = true 时使用共轭旋转因子 (逆变换)
+template <bool DIF>
+static void sw_fft_stage(float *re, float *im, const sw_fft_plan &pl, int h, bool conj) {
+    const float *wr = &pl.tw_re[h];
+    const float *wi = conj ? &pl.tw_im_conj[h] : &pl.tw_im[h];
+    for (int b = 0; b < pl.n; b += 2 * h) {
+        float *ar = re + b, *ai = im + b;
+        float *br = re + b + h, *bi = im + b + h;
+#if SW_VW > 1
+        if (h >= SW_VW) {
+            for (int j = 0; j < h; j += SW_VW) {
+                vf_t xr = v_ld(ar + j), xi = v_ld(ai + j);
+                vf_t yr = v_ld(br + j), yi = v_ld(bi + j);
+                vf_t tr = v_ld(wr + j), ti = v_ld(wi + j);
+                if (DIF) {
+                    vf_t dr = v_sub(xr, yr), di = v_sub(xi, yi);
+                    v_st(ar + j, v_add(xr, yr));
+                    v_st(ai + j, v_add(xi, yi));
+                    v_st(br + j, v_fms(dr, tr, v_mul(di, ti)));
+                    v_st(bi + j, v_fma(dr, ti, v_mul(di, tr)));
+                } else {
+                    vf_t vr = v_fms(yr, tr, v_mul(yi, ti));
+                    vf_t vi = v_fma(yr, ti, v_mul(yi, tr));
+                    v_st(ar + j, v_add(xr, vr));
+                    v_st(ai + j, v_add(xi, vi));
+                    v_st(br + j, v_sub(xr, vr));
+                    v_st(bi + j, v_sub(xi, vi));
+                }
+            }
+            continue;
+        }
+#endif
+        for (int j = 0; j < h; j++) {
+            float tr = wr[j], ti = wi[j];
+            if (DIF) {
+                float dr = ar[j] - br[j], di = ai[j] - bi[j];
+                ar[j] += br[j];
+                ai[j] += bi[j];
+                br[j] = dr * tr - di * ti;
+                bi[j] = dr * ti + di * tr;
+            } else {
+                float vr = br[j] * tr - bi[j] * ti;
+                float vi = br[j] * ti + bi[j] * tr;
+                br[j] = ar[j] - vr;
+                bi[j] = ai[j] - vi;
+                ar[j] += vr;
+                ai[j] += vi;
+            }
+        }
+    }
+}
+
+// 正变换 DIF。mul_re/mul_im 非空时，最后一级 (h=1) 与逐点复乘融合
+static void sw_fft_dif(float *re, float *im, const sw_fft_plan &pl,
+                       const float *mul_re, const float *mul_im) {
+    for (int h = pl.n / 2; h > 1; h >>= 1) {
+        sw_fft_stage<true>(re, im, pl, h, false);
+    }
+    for (int b = 0; b < pl.n; b += 2) {
+        float r0 = re[b] + re[b + 1], i0 = im[b] + im[b + 1];
+        float r1 = re[b] - re[b + 1], i1 = im[b] - im[b + 1];
+        if (mul_re) {
+            re[b]     = r0 * mul_re[b]     - i0 * mul_im[b];
+            im[b]     = r0 * mul_im[b]     + i0 * mul_re[b];
+            re[b + 1] = r1 * mul_re[b + 1] - i1 * mul_im[b + 1];
+            im[b + 1] = r1 * mul_im[b + 1] + i1 * mul_re[b + 1];
+        } else {
+            re[b] = r0; im[b] = i0;
+            re[b + 1] = r1; im[b + 1] = i1;
+        }
+    }
+}
+
+// 逆变换 DIT (不归一化，缩放已并入系数)
+static void sw_ifft_dit(float *re, float *im, const sw_fft_plan &pl) {
+    for (int h = 1; h < pl.n; h <<= 1) {
+        sw_fft_stage<false>(re, im, pl, h, true);
+    }
+}
+
+static const sw_fft_plan &range_plan() {
+    static const sw_fft_plan pl(N_RANGE);
+    return pl;
+}
+
+static const sw_fft_plan &doppler_plan() {
+    static const sw_fft_plan pl(N_PULSE);
+    return pl;
+}
+
+// 匹配滤波系数：位反序排列，并预乘正/逆变换的缩放
+struct sw_mf_table {
+    float re[N_RANGE];
+    float im[N_RANGE];
+    sw_mf_table() {
+        const sw_fft_plan &pl = range_plan();
+        int shift = fft_sch_shift(PC_FFT_SCH, pl.log2n) + fft_sch_shift(PC_IFFT_SCH, pl.log2n);
+        float scale = std::ldexp(1.0f, -shift);
+        for (int i = 0; i < N_RANGE; i++) {
+            re[i] = SW_REF_RE(pl.bitrev[i]) * scale;
+            im[i] = SW_REF_IM(pl.bitrev[i]) * scale;
+        }
+    }
+};
+
+static const sw_mf_table &mf_table() {
+    static const sw_mf_table t;
+    return t;
+}
+
+static float *sw_alloc(size_t n) {
+    void *p = nullptr;
+    if (posix_memalign(&p, 64, n * sizeof(float)) != 0) return nullptr;
+    return (float *)p;
+}
+
+// ==========================================================================
+// 3. 线程池
+// ==========================================================================
+RadarSwBackend::RadarSwBackend(int n_threads)
+    : job_(nullptr), job_n_(0), job_gen_(0), job_pending_(0), quit_(false) {
+    if (n_threads <= 0) n_threads = (int)std::thread::hardware_concurrency();
+    if (n_threads <= 0) n_threads = 1;
+
+    pc_re_ = sw_alloc(N_PULSE * N_RANGE);
+    pc_im_ = sw_alloc(N_PULSE * N_RANGE);
+    ct_re_ = sw_alloc(N_PULSE * N_RANGE);
+    ct_im_ = sw_alloc(N_PULSE * N_RANGE);
+
+    // 提前构造静态表，避免首帧抖动
+    range_plan();
+    doppler_plan();
+    mf_table();
+
+    for (int i = 1; i < n_threads; i++) {
+        workers_.push_back(std::thread(&RadarSwBackend::worker_loop, this, i));
+    }
+}
+
+RadarSwBackend::~RadarSwBackend() {
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        quit_ = true;
+    }
+    cv_start_.notify_all();
+    for (size_t i = 0; i < workers_.size(); i++) workers_[i].join();
+    free(pc_re_); free(pc_im_);
+    free(ct_re_); free(ct_im_);
+}
+
+void RadarSwBackend::worker_loop(int id) {
+    int seen = 0;
+    for (;;) {
+        const std::function<void(int, int)> *job;
+        int n;
+        {
+            std::unique_lock<std::mutex> lk(mtx_);
+            cv_start_.wait(lk, [&] { return quit_ || job_gen_ != seen; });
+            if (quit_) return;
+            seen = job_gen_;
+            job = job_;
+            n = job_n_;
+        }
+        int nt = threads();
+        (*job)(n * id / nt, n * (id + 1) / nt);
+        {
+            std::lock_guard<std::mutex> lk(mtx_);
+            if (--job_pending_ == 0) cv_done_.notify_one();
+        }
+    }
+}
+
+void RadarSwBackend::parallel_for(int n, const std::function<void(int, int)> &fn) {
+    if (workers_.empty()) {
+        fn(0, n);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        job_ = &fn;
+        job_n_ = n;
+        job_pending_ = (int)workers_.size();
+        job_gen_++;
+    }
+    cv_start_.notify_all();
+    fn(0, n / threads());
+    std::unique_lock<std::mutex> lk(mtx_);
+    cv_done_.wait(lk, [&] { return job_pending_ == 0; });
+}
+
+// ==========================================================================
+// 4. 一帧处理
+// ==========================================================================
+void RadarSwBackend::process(const uint32_t *in_words, float *out_iq,
+                             int n_pulse, const float *win,
+                             int presum_log2, uint16_t presum_fcw,
+                             int fir_taps, const float *fir_re, const float *fir_im) {
+    const sw_fft_plan &rpl = range_plan();
+    const sw_fft_plan &dpl = doppler_plan();
+    const sw_mf_table &mf = mf_table();
+    const float adc_scale = 1.0f / 8192.0f; // ap_fixed<14,1>: 13 位小数
+    const float dop_scale = std::ldexp(1.0f, -(RD_DP_SHIFT - PC_DP_SHIFT));   // 与 radar_top 的 RD 刻度一致
+    const float fir_scale = std::ldexp(1.0f, -PC_FIR_SHIFT);
+
+    if (n_pulse <= 0 || n_pulse > N_PULSE) n_pulse = N_PULSE;
+    if (presum_log2 < 0 || presum_log2 > PRESUM_MAX_LOG2) presum_log2 = 0;
+    const int k = 1 << presum_log2;
+
+    if (fir_taps > PC_FIR_MAX_TAPS) fir_taps = PC_FIR_MAX_TAPS;
+
+    // Phase 1: 解包 (+ 预积累) + 正 FFT (融合匹配滤波) + IFFT 或短码 FIR，按脉冲并行
+    parallel_for(n_pulse, [&](int p0, int p1) {
+        for (int p = p0; p < p1; p++) {
+            float *re = pc_re_ + p * N_RANGE;
+            float *im = pc_im_ + p * N_RANGE;
+            if (k == 1 && presum_fcw == 0) {
+                const uint32_t *w = in_words + p * N_RANGE;
+                for (int r = 0; r < N_RANGE; r++) {
+                    int32_t raw_re = (int32_t)(w[r] << 18) >> 18;
+                    int32_t raw_im = (int32_t)(w[r] << 2) >> 18;
+                    re[r] = raw_re * adc_scale;
+                    im[r] = raw_im * adc_scale;
+                }
+            } else {
+                // 第 m 个输入脉冲乘 exp(-j*2*pi*fcw*m/2^16) 后平均
+                for (int r = 0; r < N_RANGE; r++) re[r] = im[r] = 0.0f;
+                for (int j = 0; j < k; j++) {
+                    const int m = p * k + j;
+                    const double ph = -2.0 * M_PI * (uint16_t)(presum_fcw * m) / 65536.0;
+                    const float c = (float)std::cos(ph) * adc_scale / k;
+                    const float s = (float)std::sin(ph) * adc_scale / k;
+                    const uint32_t *w = in_words + (size_t)m * N_RANGE;
+                    for (int r = 0; r < N_RANGE; r++) {
+                        float x_re = (float)((int32_t)(w[r] << 18) >> 18);
+                        float x_im = (float)((int32_t)(w[r] << 2) >> 18);
+                        re[r] += x_re * c - x_im * s;
+                        im[r] += x_re * s + x_im * c;
+                    }
+                }
+            }
+            if (fir_taps > 0) {
+                // 线性相关，脉冲末尾只累加本脉冲内的样点
+                float x_re[N_RANGE], x_im[N_RANGE];
+                memcpy(x_re, re, sizeof(x_re));
+                memcpy(x_im, im, sizeof(x_im));
+                for (int r = 0; r < N_RANGE; r++) {
+                    float acc_re = 0.0f, acc_im = 0.0f;
+                    for (int t = 0; t < fir_taps && r + t < N_RANGE; t++) {
+                        acc_re += fir_re[t] * x_re[r + t] - fir_im[t] * x_im[r + t];
+                        acc_im += fir_re[t] * x_im[r + t] + fir_im[t] * x_re[r + t];
+                    }
+                    re[r] = acc_re * fir_scale;
+                    im[r] = acc_im * fir_scale;
+                }
+                continue;
+            }
+            sw_fft_dif(re, im, rpl, mf.re, mf.im);
+            sw_ifft_dit(re, im, rpl);
+        }
+    });
+
+    // 角转换：16x16 分块转置，同时乘上多普勒 FFT 缩放与慢时间窗，超出 n_pulse 的部分补零
+    const int TB = 16;
+    parallel_for(N_RANGE / TB, [&](int t0, int t1) {
+        for (int rt = t0 * TB; rt < t1 * TB; rt += TB) {
+            for (int pt = 0; pt < N_PULSE; pt += TB) {
+                for (int p = pt; p < pt + TB && p < N_PULSE; p++) {
+                    float g = win ? win[p] * dop_scale : dop_scale;
+                    for (int r = rt; r < rt + TB && r < N_RANGE; r++) {
+                        ct_re_[r * N_PULSE + p] = p < n_pulse ? pc_re_[p * N_RANGE + r] * g : 0.0f;
+                        ct_im_[r * N_PULSE + p] = p < n_pulse ? pc_im_[p * N_RANGE + r] * g : 0.0f;
+                    }
+                }
+            }
+        }
+    });
+
+    // Phase 2: 多普勒 FFT，按距离列并行；输出时做位反序收集并交织成 (re, im)
+    parallel_for(N_RANGE, [&](int r0, int r1) {
+        for (int r = r0; r < r1; r++) {
+            float *re = ct_re_ + r * N_PULSE;
+            float *im = ct_im_ + r * N_PULSE;
+            sw_fft_dif(re, im, dpl, nullptr, nullptr);
+            float *o = out_iq + (size_t)r * N_PULSE * 2;
+            for (int d = 0; d < N_PULSE; d++) {
+                int s = dpl.bitrev[d];
+                o[2 * d] = re[s];
+                o[2 * d + 1] = im[s];
+            }
+        }
+    });
+}
+
+// ==========================================================================
+// 5. 与 radar_top 相同的流接口封装
+// ==========================================================================
+void radar_top_sw(stream_in_t &input,
+                  stream_rd_t &output,
+                  radar_ctrl_t ctrl,
+                  const dop_win_t dop_win[N_PULSE],
+                  const pc_fir_tap_t pc_fir_tap[PC_FIR_MAX_TAPS],
+                  ap_uint<32> *dbg_fft_in_cnt,
+                  ap_uint<32> *dbg_fft_out_cnt) {
+    static RadarSwBackend backend;
+    static std::vector<uint32_t> in_words(PRESUM_MAX_PULSES * N_RANGE);
+    static std::vector<float> out_iq(N_PULSE * N_RANGE * 2);
+
+    static pulse_meta_t meta_tbl[N_PULSE];
+    static ap_uint<32> frame_cnt = 0;
+
+    const int n_pulse = radar_ctrl_pulses(ctrl);
+    const int log2k = radar_ctrl_presum(ctrl);
+    const int n_in = radar_ctrl_in_pulses(ctrl);
+    rx_sync_t sync;
+    rx_sync_init(sync, ctrl.tlast_pulse);
+    for (int m = 0; m < n_in; m++) {
+        pulse_meta_t meta;
+        for (int i = 0; i < N_RANGE; i++) {
+            axis_in_t pkt = rx_sync_beat(input, sync, i);
+            in_words[m * N_RANGE + i] = pkt.data.to_uint();
+            if (i == 0) meta = pulse_meta_unpack(pkt.user);
+        }
+        meta.rx_err = rx_sync_end(input, sync, m == n_in - 1);
+        // 预积累时保留每组首个脉冲的元数据，rx_err 取组内的或
+        if ((m & ((1 << log2k) - 1)) == 0) meta_tbl[m >> log2k] = meta;
+        else meta_tbl[m >> log2k].rx_err |= meta.rx_err;
+    }
+
+    float win[N_PULSE];
+    for (int p = 0; p < N_PULSE; p++) win[p] = (float)dop_win[p].to_double();
+
+    float fir_re[PC_FIR_MAX_TAPS], fir_im[PC_FIR_MAX_TAPS];
+    const int fir_taps = radar_ctrl_pc_fir(ctrl);
+    for (int t = 0; t < fir_taps; t++) {
+        fir_re[t] = (float)pc_fir_tap[t].real().to_double();
+        fir_im[t] = (float)pc_fir_tap[t].imag().to_double();
+    }
+
+    backend.process(in_words.data(), out_iq.data(), n_pulse, ctrl.win_en ? win : nullptr,
+                    log2k, (uint16_t)ctrl.presum_fcw.to_uint(), fir_taps, fir_re, fir_im);
+
+    // 帧头 (与 radar_top 相同)
+    ap_uint<32> flags = frame_hdr_flags(meta_tbl, ctrl);
+    ap_uint<32> band = frame_hdr_band(ctrl);
+    ap_uint<32> rx_err = frame_hdr_rx_err(meta_tbl, ctrl);
+    for (int b = 0; b < FRAME_HDR_BEATS; b++) {
+        axis_rd_t pkt;
+        for (int k = 0; k < OUT_CELLS_PER_BEAT; k++) {
+            rd_beat_set_word(pkt, k, frame_hdr_word(b * OUT_CELLS_PER_BEAT + k, frame_cnt, flags, band, rx_err, meta_tbl));
+        }
+        pkt.last = 0;
+        pkt.keep = -1;
+        pkt.strb = -1;
+        output.write(pkt);
+    }
+    frame_cnt++;
+
+    // 与 radar_top 相同的输出顺序与 beat 打包 (每行/列尾可能为部分 beat)，多普勒子带只输出选定 bin
+    const int n_bins = radar_ctrl_dop_bins(ctrl);
+    const int n_outer = ctrl.dop_major ? n_bins : N_RANGE;
+    const int n_inner = ctrl.dop_major ? N_RANGE : n_bins;
+    for (int o = 0; o < n_outer; o++) {
+        axis_rd_t pkt;
+        int slot = 0;
+        for (int n = 0; n < n_inner; n++) {
+            int r = ctrl.dop_major ? n : o;
+            int d = radar_ctrl_fft_bin(ctrl, ctrl.dop_major ? o : n);
+            int i = r * N_PULSE + d;
+            rd_beat_set_cell(pkt, slot, (fft_data_t)out_iq[2 * i], (fft_data_t)out_iq[2 * i + 1]);
+            bool row_end = (n == n_inner - 1);
+            if (slot == OUT_CELLS_PER_BEAT - 1 || row_end) {
+                ap_uint<4 * OUT_CELLS_PER_BEAT> keep = 0;
+                for (int k = 0; k <= slot; k++) keep.range(4 * k + 3, 4 * k) = 0xF;
+                pkt.last = (o == n_outer - 1) && row_end;
+                pkt.keep = keep;
+                pkt.strb = keep;
+                output.write(pkt);
+                slot = 0;
+            } else {
+                slot++;
+            }
+        }
+    }
+
+    *dbg_fft_in_cnt = N_RANGE * N_PULSE;
+    *dbg_fft_out_cnt = N_RANGE * N_PULSE;
+}
@@ -0,0 +1,59 @@
+#ifndef RADAR_SW_H
+#define RADAR_SW_H
+
+#include "radar_defines.h"
+#include <cstdint>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+// ==========================================
+// CPU 软件后端 (浮点 + SIMD)
+// 输入：N_PULSE * N_RANGE 个 32bit 字，打包格式与 axis_in_t.data 一致
+//       ([13:0] 实部, [29:16] 虚部, 14位补码)
+// 输出：N_RANGE * N_PULSE 个复数 (re, im 交织)，距离优先顺序与 radar_top 一致
+//       即 out[(r * N_PULSE + d) * 2 + {0,1}]
+// 缩放与 radar_top 一致 (PC_DP_SHIFT / RD_DP_SHIFT，定点版本即 PC_FFT_SCH / PC_IFFT_SCH / DOP_FFT_SCH)
+// n_pulse < N_PULSE 时只读前 n_pulse 个脉冲，多普勒 FFT 前补零；win 非空时乘慢时间窗
+// presum_log2 > 0 时输入为 n_pulse * K 个脉冲，与 radar_top 一样相参平均为 n_pulse 行
+// (脉压是线性的，这里在脉压前积累，K 个脉冲只做一次 FFT)
+// fir_taps > 0 时脉压为短码线性相关 2^-PC_FIR_SHIFT * sum_k fir[k] * x[i+k] (与 pulse_compression_fir 相同)
+// ==========================================
+class RadarSwBackend {
+public:
+    // n_threads <= 0 时使用硬件线程数
+    explicit RadarSwBackend(int n_threads = 0);
+    ~RadarSwBackend();
+
+    void process(const uint32_t *in_words, float *out_iq,
+                 int n_pulse = N_PULSE, const float *win = nullptr,
+                 int presum_log2 = 0, uint16_t presum_fcw = 0,
+                 int fir_taps = 0, const float *fir_re = nullptr, const float *fir_im = nullptr);
+
+    int threads() const { return (int)workers_.size() + 1; }
+
+private:
+    RadarSwBackend(const RadarSwBackend &);
+    RadarSwBackend &operator=(const RadarSwBackend &);
+
+    // 简单常驻线程池：主线程也参与计算
+    void parallel_for(int n, const std::function<void(int, int)> &fn);
+    void worker_loop(int id);
+
+    std::vector<std::thread> workers_;
+    std::mutex mtx_;
+    std::condition_variable cv_start_, cv_done_;
+    const std::function<void(int, int)> *job_;
+    int job_n_;
+    int job_gen_;
+    int job_pending_;
+    bool quit_;
+
+    // 工作矩阵 (实虚分离, 64 字节对齐)
+    float *pc_re_, *pc_im_;   // [N_PULSE][N_RANGE] 脉压结果
+    float *ct_re_, *ct_im_;   // [N_RANGE][N_PULSE] 转置后
+};
+
+#endif
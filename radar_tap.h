@@ -0,0 +1,111 @@
+#ifndef RADAR_TAP_H
+#define RADAR_TAP_H
+
+#include "radar_defines.h"
+
+// =========================================================
+// [Phase 1 Helper] 距离像旁路 (radar_top_tap)
+// 分叉：脉压结果原样转给预积累，同时按 tap_ctrl 算出旁路单元 (复数或 |X|^2，按组抽取)
+// 旁路单元经 TAP_FIFO_PULSES 个脉冲深度的 FIFO 交给打包任务；每个脉冲开始时用 write_nb
+// 向待打包队列登记，队列满 (打包任务落后) 则整个脉冲不旁路，分叉从不阻塞在旁路侧
+// 待打包队列深度 TAP_FIFO_PULSES - 1，加上打包任务正在输出的一个，单元 FIFO 不会写满
+//
+// 待打包队列的类型 PEND 为模板参数：radar_top 中为 hls::stream<tap_pend_t>，
+// tb_range_tap 换成定深队列单独驱动分叉，检验队列写满时的丢弃路径
+// (C-sim 中 hls::stream 无界、Dataflow 各任务顺序执行，整核仿真时 write_nb 不会失败)
+// =========================================================
+static_assert(TAP_FIFO_PULSES >= 2, "tap needs room for the pulse being packed plus one pending");
+
+struct tap_pend_t {
+    pulse_meta_t meta;
+    ap_uint<1>   end;       // 1 = 本 CPI 结束 (不带脉冲)
+};
+
+template <class PEND>
+void p1_tap_fork(stream_dp_t &in_stream,
+                 stream_meta_t &meta_in,
+                 stream_dp_t &out_stream,
+                 stream_meta_t &meta_out,
+                 hls::stream<ap_uint<32> > &tap_words,
+                 PEND &tap_pend,
+                 tap_ctrl_t tap_ctrl,
+                 int n_in,
+                 ap_uint<32> &tap_drop) {
+    #pragma HLS INLINE off
+    const int mode = tap_ctrl.mode;
+    const bool tap_on = (mode == 1 || mode == 2);
+    const int d_mask = (1 << tap_ctrl_decim(tap_ctrl)) - 1;
+    dop_pow_t pw_max = 0;
+    ap_uint<32> n_drop = 0;
+    bool take = false;
+    Tap_Pulse_Loop: for (int m = 0; m < n_in; m++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=PRESUM_MAX_PULSES
+        Tap_Range_Loop: for (int r = 0; r < N_RANGE; r++) {
+            #pragma HLS PIPELINE II=1
+            if (r == 0) {
+                pulse_meta_t meta = meta_in.read();
+                meta_out.write(meta);
+                tap_pend_t pend;
+                pend.meta = meta;
+                pend.end = 0;
+                take = tap_on && tap_pend.write_nb(pend);
+                if (tap_on && !take) n_drop++;
+            }
+            dp_complex_t v = in_stream.read();
+            out_stream.write(v);
+
+            complex_t c = dp_to_fixed<PC_DP_SHIFT>(v);
+            dop_pow_t pw = (dop_pow_t)(c.real() * c.real()) + (dop_pow_t)(c.imag() * c.imag());
+            const bool grp_first = (r & d_mask) == 0;
+            const bool grp_last = (r & d_mask) == d_mask;
+            if (grp_first || pw > pw_max) pw_max = pw;
+
+            ap_uint<32> w;
+            if (take && mode == 1 && grp_first) {
+                w.range(15, 0) = c.real().range(15, 0);
+                w.range(31, 16) = c.imag().range(15, 0);
+                tap_words.write(w);
+            } else if (take && mode == 2 && grp_last) {
+                w = pw_max.range(31, 0);
+                tap_words.write(w);
+            }
+        }
+    }
+    // 结束标记允许阻塞：此时主通路数据已全部转出
+    if (tap_on) {
+        tap_pend_t pend;
+        pend.meta = pulse_meta_t();
+        pend.end = 1;
+        tap_pend.write(pend);
+    }
+    tap_drop = n_drop;
+}
+
+// 打包：每个登记的脉冲输出元数据与 N_RANGE >> decim_log2 个单元，TLAST 在脉冲末尾
+template <class PEND>
+void p1_tap_writer(hls::stream<ap_uint<32> > &tap_words,
+                   PEND &tap_pend,
+                   stream_rd_t &tap_output,
+                   stream_meta_t &tap_meta,
+                   tap_ctrl_t tap_ctrl,
+                   int n_in) {
+    #pragma HLS INLINE off
+    if (tap_ctrl.mode != 1 && tap_ctrl.mode != 2) return;
+    const int n_cells = N_RANGE >> tap_ctrl_decim(tap_ctrl);
+    axis_rd_t out_pkt;
+    int slot = 0;
+    Tap_Pulse_Loop: for (int m = 0; m <= n_in; m++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=PRESUM_MAX_PULSES
+        tap_pend_t pend = tap_pend.read();
+        if (pend.end) break;
+        tap_meta.write(pend.meta);
+        Tap_Cell_Loop: for (int i = 0; i < n_cells; i++) {
+            #pragma HLS LOOP_TRIPCOUNT min=N_RANGE/(1<<TAP_MAX_DECIM_LOG2) max=N_RANGE
+            #pragma HLS PIPELINE II=1
+            bool pulse_end = (i == n_cells - 1);
+            rd_push_word(tap_output, out_pkt, slot, tap_words.read(), pulse_end, pulse_end);
+        }
+    }
+}
+
+#endif
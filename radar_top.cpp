@@ -1,52 +1,663 @@
 #include "radar_defines.h"
+#include "radar_coeffs_gen.h"
+#include "radar_fft.h"
+#include "radar_tap.h"
+#include <cmath>
 #include <cstdio>
 
+#ifdef CT_COMPRESS
 // =========================================================
-// [Phase 1 Helper] 将脉压结果存入矩阵 (消费者)
+// [角转换压缩] 块浮点辅助函数
+// 每个脉冲共享一个指数 e：存储 round(x * 2^e) 的 CT_MANT_BITS 位尾数
+// e 取该脉冲所有分量中冗余符号位的最小值，保证左移不溢出
 // =========================================================
-static void store_pulse_to_matrix(stream_out_t &in_stream,
-                                  complex_t matrix[N_PULSE][N_RANGE],
-                                  int pulse_idx) {
+static ap_uint<16> ct_mag_bits(fft_data_t v) {
+    #pragma HLS INLINE
+    ap_uint<16> raw = v.range(15, 0);
+    return raw[15] ? (ap_uint<16>)(~raw) : raw;
+}
+
+static ct_exp_t ct_norm_shift(ap_uint<16> mag_or) {
+    #pragma HLS INLINE
+    ct_exp_t e = 15;
+    for (int b = 0; b < 15; b++) {
+        #pragma HLS UNROLL
+        if (mag_or[b]) e = 14 - b;
+    }
+    return e;
+}
+
+static ap_uint<2 * CT_MANT_BITS> ct_pack_cell(complex_t c, ct_exp_t e) {
+    #pragma HLS INLINE
+    ct_mant_t m_re = (fft_data_t)(c.real() << e);
+    ct_mant_t m_im = (fft_data_t)(c.imag() << e);
+    ap_uint<2 * CT_MANT_BITS> cell;
+    cell.range(CT_MANT_BITS - 1, 0) = m_re.range(CT_MANT_BITS - 1, 0);
+    cell.range(2 * CT_MANT_BITS - 1, CT_MANT_BITS) = m_im.range(CT_MANT_BITS - 1, 0);
+    return cell;
+}
+
+static complex_t ct_unpack_cell(ct_word_t word, int slot, ct_exp_t e) {
+    #pragma HLS INLINE
+    ap_uint<2 * CT_MANT_BITS> cell = word >> (slot * 2 * CT_MANT_BITS);
+    ct_mant_t m_re, m_im;
+    m_re.range(CT_MANT_BITS - 1, 0) = cell.range(CT_MANT_BITS - 1, 0);
+    m_im.range(CT_MANT_BITS - 1, 0) = cell.range(2 * CT_MANT_BITS - 1, CT_MANT_BITS);
+    fft_data_t re = m_re;
+    fft_data_t im = m_im;
+    re >>= e;
+    im >>= e;
+    return complex_t(re, im);
+}
+#endif
+
+// =========================================================
+// [Phase 1 Helper] 将整个 CPI 的脉压结果存入矩阵 (消费者)
+// 与 pulse_compression_cpi 同在一个 Dataflow 区域，脉冲首尾相接 II=1
+// 只写前 n_pulse 行，其余行不清零 (Phase 2 读列时直接补零，不访问)
+// =========================================================
+static void store_cpi_to_matrix(stream_dp_t &in_stream,
+                                stream_meta_t &meta_stream,
+                                ct_word_t matrix[N_PULSE][CT_WORDS],
+                                ct_exp_t ct_exp[N_PULSE],
+                                pulse_meta_t meta_tbl[N_PULSE],
+                                int n_pulse) {
     #pragma HLS INLINE off
-    for (int r = 0; r < N_RANGE; r++) {
-        #pragma HLS PIPELINE II=1
-        axis_out_t val_pkt = in_stream.read(); // 阻塞读取，有数据就拿走
-        complex_t c_val;
-        c_val.real(val_pkt.data.re);
-        c_val.imag(val_pkt.data.im);
-        matrix[pulse_idx][r] = c_val;
+#ifdef CT_COMPRESS
+    // 两行乒乓缓存：读入第 c 个脉冲 (同时求共享指数) 的同时，
+    // 用上一脉冲的指数压缩打包第 c-1 个脉冲，多一个脉冲延迟，整体仍为 II=1
+    complex_t line[2][N_RANGE];
+    #pragma HLS ARRAY_PARTITION variable=line complete dim=1
+    #pragma HLS DEPENDENCE variable=line inter false
+
+    ap_uint<16> mag_or = 0;
+    ct_exp_t e_prev = 0;
+    ct_word_t word = 0;
+    int slot = 0;
+    int w = 0;
+    Ct_Pulse_Loop: for (int c = 0; c <= n_pulse; c++) {
+        #pragma HLS LOOP_TRIPCOUNT min=2 max=N_PULSE+1
+        Ct_Range_Loop: for (int r = 0; r < N_RANGE; r++) {
+            #pragma HLS PIPELINE II=1
+            if (c < n_pulse) {
+                // 元数据随 CPI 一起保存在角转换侧
+                if (r == 0) meta_tbl[c] = meta_stream.read();
+                complex_t c_val = in_stream.read();
+                line[c & 1][r] = c_val;
+                mag_or |= ct_mag_bits(c_val.real()) | ct_mag_bits(c_val.imag());
+            }
+            if (c > 0) {
+                if (r == 0) w = 0;
+                word |= (ct_word_t)ct_pack_cell(line[(c - 1) & 1][r], e_prev) << (slot * 2 * CT_MANT_BITS);
+                if (slot == CT_PACK - 1 || r == N_RANGE - 1) {
+                    matrix[c - 1][w] = word;
+                    word = 0;
+                    slot = 0;
+                    w++;
+                } else {
+                    slot++;
+                }
+            }
+            // 脉冲结束：锁存本脉冲指数，供下一轮打包使用
+            if (r == N_RANGE - 1 && c < n_pulse) {
+                e_prev = ct_norm_shift(mag_or);
+                ct_exp[c] = e_prev;
+                mag_or = 0;
+            }
+        }
+    }
+#else
+    (void)ct_exp;
+    Store_Pulse_Loop: for (int p = 0; p < n_pulse; p++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=N_PULSE
+        Store_Range_Loop: for (int r = 0; r < N_RANGE; r++) {
+            #pragma HLS PIPELINE II=1
+            // 元数据随 CPI 一起保存在角转换侧
+            if (r == 0) meta_tbl[p] = meta_stream.read();
+            matrix[p][r] = in_stream.read(); // 阻塞读取，有数据就拿走
+        }
+    }
+#endif
+}
+
+// =========================================================
+// [Phase 1 Helper] 相参预积累 (位于脉压与存储之间)
+// 每 K 个相邻脉冲 (可选先乘脉间相位补偿) 在行缓存中累加，组内最后一个脉冲输出平均值
+// 平均后刻度不变，后级 (存储 / 多普勒 FFT / 输出移位) 无需改动
+// 每组转发首个脉冲的元数据，rx_err 取组内各脉冲的或 (组内最后一个脉冲时写出)
+// K = 1 且不补偿时输出与输入逐位相同
+// =========================================================
+static const int PRESUM_NCO_N = 1 << PRESUM_NCO_LUT_BITS;
+
+// 相位补偿表即 r=1 的旋转因子表 exp(+j*2*pi*k/N)，使用时取共轭
+static constexpr coeff_gen::table_t<PRESUM_NCO_N> PRESUM_NCO_TABLE =
+    coeff_gen::make_sdft_twiddle<PRESUM_NCO_N>(1.0);
+static const std::complex<presum_nco_t> (&PRESUM_NCO_ROM)[PRESUM_NCO_N] =
+    coeff_gen::rom<std::complex<presum_nco_t>, PRESUM_NCO_N, PRESUM_NCO_TABLE,
+                   std::make_index_sequence<PRESUM_NCO_N>>::table;
+
+static dp_data_t presum_avg(presum_acc_t s, int log2k) {
+#ifdef RADAR_FLOAT_DATAPATH
+    return std::ldexp(s, -log2k);
+#else
+    return ap_fixed<16, 1, AP_RND, AP_SAT>(s >> log2k);
+#endif
+}
+
+// 乘脉间相位补偿 v * conj(lo) (fcw = 0 时直接转换)，结果进累加器
+static void presum_mix(dp_complex_t v, std::complex<presum_nco_t> lo, bool mix,
+                       presum_acc_t &re, presum_acc_t &im) {
+    #pragma HLS INLINE
+    re = v.real();
+    im = v.imag();
+    if (mix) {
+        re = v.real() * lo.real() + v.imag() * lo.imag();
+        im = v.imag() * lo.real() - v.real() * lo.imag();
+    }
+}
+
+static void presum_pulses(stream_dp_t &in_stream,
+                          stream_meta_t &meta_in,
+                          stream_dp_t &out_stream,
+                          stream_meta_t &meta_out,
+                          int n_pulse,
+                          int log2k,
+                          ap_uint<16> fcw) {
+    #pragma HLS INLINE off
+    presum_acc_t acc_re[N_RANGE], acc_im[N_RANGE];
+    #pragma HLS DEPENDENCE variable=acc_re inter false
+    #pragma HLS DEPENDENCE variable=acc_im inter false
+
+    const int n_in = n_pulse << log2k;
+    const int k_last = (1 << log2k) - 1;
+    ap_uint<16> phase = 0;
+    pulse_meta_t grp_meta;
+    Presum_Pulse_Loop: for (int m = 0; m < n_in; m++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=PRESUM_MAX_PULSES
+        const int j = m & k_last;
+        const std::complex<presum_nco_t> lo = PRESUM_NCO_ROM[phase.range(15, 16 - PRESUM_NCO_LUT_BITS)];
+        Presum_Range_Loop: for (int r = 0; r < N_RANGE; r++) {
+            #pragma HLS PIPELINE II=1
+            if (r == 0) {
+                pulse_meta_t meta = meta_in.read();
+                if (j == 0) grp_meta = meta;
+                else grp_meta.rx_err |= meta.rx_err;
+                if (j == k_last) meta_out.write(grp_meta);
+            }
+            presum_acc_t re, im;
+            presum_mix(in_stream.read(), lo, fcw != 0, re, im);
+            if (j != 0) {
+                re += acc_re[r];
+                im += acc_im[r];
+            }
+            if (j == k_last) {
+                out_stream.write(dp_complex_t(presum_avg(re, log2k), presum_avg(im, log2k)));
+            } else {
+                acc_re[r] = re;
+                acc_im[r] = im;
+            }
+        }
+        phase += fcw;
     }
 }
 
 // =========================================================
-// [Phase 1 Logic] 单脉冲处理 Dataflow 封装
-// 作用：让 pulse_compression (生产) 和 store (消费) 并行运行
-// 彻底消除 FIFO 满导致的死锁
+// [Phase 1 Logic] 整个 CPI 的连续脉压 Dataflow 区域
+// 作用：pulse_compression_cpi (生产) 和 store (消费) 并行运行，
+// 脉冲之间不再重新进入 Dataflow、不再重复 FFT/IFFT 填充排空，
+// 脉冲间隔降为 N_RANGE 个周期
 // =========================================================
-static void process_single_pulse(stream_in_t &input,
-                                 complex_t matrix[N_PULSE][N_RANGE],
-                                 int pulse_idx) {
+static void run_phase1_stream(stream_in_t &input,
+                              ct_word_t matrix[N_PULSE][CT_WORDS],
+                              ct_exp_t ct_exp[N_PULSE],
+                              pulse_meta_t meta_tbl[N_PULSE],
+                              radar_ctrl_t ctrl,
+                              const pc_fir_tap_t pc_fir_tap[PC_FIR_MAX_TAPS]) {
+    #pragma HLS INLINE off
+    #pragma HLS DATAFLOW
+
+    const int n_pulse = radar_ctrl_pulses(ctrl);
+    const int log2k = radar_ctrl_presum(ctrl);
+
+    // 局部流：连接脉压、预积累和存储
+    // 元数据在输入端每个脉冲读完时写出，比数据早 FFT+IFFT 延迟 (几个脉冲)，深度要覆盖这段
+    stream_dp_t pc_out_stream, ps_out_stream;
+    stream_meta_t meta_stream, ps_meta_stream;
+    #pragma HLS STREAM variable=pc_out_stream depth=16 type=fifo
+    #pragma HLS STREAM variable=meta_stream depth=16 type=fifo
+    #pragma HLS STREAM variable=ps_out_stream depth=16 type=fifo
+    #pragma HLS STREAM variable=ps_meta_stream depth=4 type=fifo
+
+    // 任务 A: 脉冲压缩 (生产者)，数据通路类型直接入存储，按输入脉冲数运行
+    pulse_compression_cpi_dp(input, pc_out_stream, meta_stream, n_pulse << log2k, pc_fir_tap,
+                             radar_ctrl_pc_fir(ctrl), ctrl.tlast_pulse);
+
+    // 任务 B: 相参预积累，K 个脉冲合为一行
+    presum_pulses(pc_out_stream, meta_stream, ps_out_stream, ps_meta_stream, n_pulse, log2k, ctrl.presum_fcw);
+
+    // 任务 C: 存入矩阵 (消费者)
+    store_cpi_to_matrix(ps_out_stream, ps_meta_stream, matrix, ct_exp, meta_tbl, n_pulse);
+}
+
+// Phase 1 + 距离像旁路：run_phase1_stream 在脉压与预积累之间插入分叉
+static void run_phase1_stream_tap(stream_in_t &input,
+                                  ct_word_t matrix[N_PULSE][CT_WORDS],
+                                  ct_exp_t ct_exp[N_PULSE],
+                                  pulse_meta_t meta_tbl[N_PULSE],
+                                  radar_ctrl_t ctrl,
+                                  const pc_fir_tap_t pc_fir_tap[PC_FIR_MAX_TAPS],
+                                  stream_rd_t &tap_output,
+                                  stream_meta_t &tap_meta,
+                                  tap_ctrl_t tap_ctrl,
+                                  ap_uint<32> &tap_drop) {
     #pragma HLS INLINE off
-    #pragma HLS DATAFLOW // <--- 关键！开启并行
+    #pragma HLS DATAFLOW
+
+    const int n_pulse = radar_ctrl_pulses(ctrl);
+    const int log2k = radar_ctrl_presum(ctrl);
+    const int n_in = n_pulse << log2k;
 
-    // 局部流：连接脉压和存储
-    // 因为是并行读写，深度设为 16 就极其安全，不需要 128 了
-    stream_out_t pc_out_stream;
+    stream_dp_t pc_out_stream, fk_out_stream, ps_out_stream;
+    stream_meta_t meta_stream, fk_meta_stream, ps_meta_stream;
+    hls::stream<ap_uint<32> > tap_words;
+    hls::stream<tap_pend_t> tap_pend;
     #pragma HLS STREAM variable=pc_out_stream depth=16 type=fifo
+    #pragma HLS STREAM variable=meta_stream depth=16 type=fifo
+    #pragma HLS STREAM variable=fk_out_stream depth=16 type=fifo
+    #pragma HLS STREAM variable=fk_meta_stream depth=4 type=fifo
+    #pragma HLS STREAM variable=ps_out_stream depth=16 type=fifo
+    #pragma HLS STREAM variable=ps_meta_stream depth=4 type=fifo
+    #pragma HLS STREAM variable=tap_words depth=TAP_FIFO_PULSES*N_RANGE type=fifo
+    #pragma HLS STREAM variable=tap_pend depth=TAP_FIFO_PULSES-1 type=fifo
 
-    // 任务 A: 脉冲压缩 (生产者)
-    pulse_compression(input, pc_out_stream);
+    pulse_compression_cpi_dp(input, pc_out_stream, meta_stream, n_in, pc_fir_tap, radar_ctrl_pc_fir(ctrl),
+                             ctrl.tlast_pulse);
+    p1_tap_fork(pc_out_stream, meta_stream, fk_out_stream, fk_meta_stream, tap_words, tap_pend, tap_ctrl, n_in,
+                tap_drop);
+    p1_tap_writer(tap_words, tap_pend, tap_output, tap_meta, tap_ctrl, n_in);
+    presum_pulses(fk_out_stream, fk_meta_stream, ps_out_stream, ps_meta_stream, n_pulse, log2k, ctrl.presum_fcw);
+    store_cpi_to_matrix(ps_out_stream, ps_meta_stream, matrix, ct_exp, meta_tbl, n_pulse);
+}
+
+
+// =========================================================
+// [Phase 2 Helper] 读矩阵单元 (压缩存储时在此解压)
+// =========================================================
+static dp_complex_t ct_read_cell(ct_word_t mem_matrix[N_PULSE][CT_WORDS],
+                                 ct_exp_t ct_exp[N_PULSE],
+                                 int p, int r) {
+    #pragma HLS INLINE
+#ifdef CT_COMPRESS
+    return ct_unpack_cell(mem_matrix[p][r / CT_PACK], r % CT_PACK, ct_exp[p]);
+#else
+    (void)ct_exp;
+    return mem_matrix[p][r];
+#endif
+}
+
+// =========================================================
+// [Phase 2 Helper] 多普勒 FFT 的列输入 (Stage A)
+// p >= n_pulse 直接给 0 (补零不读存储)，有效脉冲按需乘慢时间窗
+// 补零和加窗都在读列的同一拍内完成，没有额外的存储访问或周期
+// =========================================================
+static dp_complex_t dop_load_cell(ct_word_t mem_matrix[N_PULSE][CT_WORDS],
+                                  ct_exp_t ct_exp[N_PULSE],
+                                  const dop_win_t dop_win[N_PULSE],
+                                  int n_pulse, bool win_en,
+                                  int p, int r) {
+    #pragma HLS INLINE
+    dp_data_t re = 0, im = 0;
+    if (p < n_pulse) {
+        dp_complex_t v = ct_read_cell(mem_matrix, ct_exp, p, r);
+        re = v.real();
+        im = v.imag();
+        if (win_en) {
+#ifdef RADAR_FLOAT_DATAPATH
+            float w = dop_win[p].to_float();
+#else
+            dop_win_t w = dop_win[p];
+#endif
+            re = re * w;
+            im = im * w;
+        }
+    }
+    return dp_complex_t(re, im);
+}
 
-    // 任务 B: 存入矩阵 (消费者)
-    store_pulse_to_matrix(pc_out_stream, matrix, pulse_idx);
+// =========================================================
+// [Phase 2 流式] 任务 A: 按列读矩阵，所有列首尾相接 II=1 送入 FFT (埋点)
+// =========================================================
+static void p2_matrix_reader(ct_word_t mem_matrix[N_PULSE][CT_WORDS],
+                             ct_exp_t ct_exp[N_PULSE],
+                             const dop_win_t dop_win[N_PULSE],
+                             radar_ctrl_t ctrl,
+                             stream_dp_t &fft_in_strm,
+                             ap_uint<32> &dbg_cnt) {
+    #pragma HLS INLINE off
+    int n_pulse = radar_ctrl_pulses(ctrl);
+    bool win_en = ctrl.win_en;
+    ap_uint<32> cnt = 0;
+    Rd_Col_Loop: for (int r = 0; r < N_RANGE; r++) {
+        Rd_Pulse_Loop: for (int p = 0; p < N_PULSE; p++) {
+            #pragma HLS PIPELINE II=1
+            fft_in_strm.write(dop_load_cell(mem_matrix, ct_exp, dop_win, n_pulse, win_en, p, r));
+            cnt++;
+        }
+    }
+    dbg_cnt = cnt;
 }
 
+// =========================================================
+// [Phase 2 流式] 任务 C: FFT 结果 -> 输出 beat (埋点)
+// 两列乒乓缓存：写第 c 列的同时按 (可能 fftshift 的) 地址读出第 c-1 列
+// 只多一列延迟，整体仍为 II=1
+// 选了多普勒子带时每列只输出前 dop_bins 个地址，其余周期只收 FFT 结果 (只裁剪输出，FFT 照做全部 bin)
+// TAP = true 时每个输出单元同时抄送 det_tap (检测级)，顺序与输出相同
+// 列缓存存放已换回 16 位的结果 (浮点数据通路在写入时换算)
+// =========================================================
+template <bool TAP>
+static void p2_output_writer(stream_dp_t &fft_out_strm,
+                             stream_rd_t &output,
+                             stream_internal_t &det_tap,
+                             radar_ctrl_t ctrl,
+                             ap_uint<32> &dbg_cnt) {
+    #pragma HLS INLINE off
+    complex_t col_buf[2][N_PULSE];
+    #pragma HLS ARRAY_PARTITION variable=col_buf complete dim=1
+    #pragma HLS DEPENDENCE variable=col_buf inter false
+
+    const int n_bins = radar_ctrl_dop_bins(ctrl);
+    axis_rd_t out_pkt;
+    int slot = 0;
+    ap_uint<32> cnt = 0;
+    Wr_Col_Loop: for (int c = 0; c <= N_RANGE; c++) {
+        Wr_Pulse_Loop: for (int p = 0; p < N_PULSE; p++) {
+            #pragma HLS PIPELINE II=1
+            if (c < N_RANGE) {
+                col_buf[c & 1][p] = dp_to_fixed<RD_DP_SHIFT>(fft_out_strm.read());
+                cnt++;
+            }
+            if (c > 0 && p < n_bins) {
+                int r = c - 1;
+                complex_t val = col_buf[r & 1][radar_ctrl_fft_bin(ctrl, p)];
+                bool col_end = (p == n_bins - 1);
+                rd_push_cell(output, out_pkt, slot, val, col_end, (r == N_RANGE - 1) && col_end);
+                if (TAP) det_tap.write(val);
+            }
+        }
+    }
+    dbg_cnt = cnt;
+}
 
+// =========================================================
+// [检测级] 距离向单元平均 CFAR (与输出同序：距离门优先，每门 N_PULSE 个多普勒单元)
+// 第 c 列到达时判决第 k = c - HALF 列：
+//   lead 参考窗 [k+G+1, k+HALF] = [c-T+1, c]，lag 参考窗 [k-HALF, k-G-1]
+// 两个窗的和按多普勒通道增量更新 (进一列、出一列)，列缓存保存最近 2*HALF+2 列功率
+// 距离边界处只用落在 [0, N_RANGE) 内的参考单元，n_ref 按列算出，判决不做除法
+// =========================================================
+static const int CFAR_HALF = CFAR_GUARD + CFAR_TRAIN;
+static const int CFAR_COLS = 2 * CFAR_HALF + 2;
+typedef ap_ufixed<40, 7> cfar_sum_t;   // 最多 2*CFAR_TRAIN 个 |X|^2 (每个 < 2)
+
+static void p2_cfar_detect(stream_internal_t &det_tap,
+                           stream_det_t &det_output,
+                           cfar_ctrl_t cfar_ctrl) {
+    #pragma HLS INLINE off
+    static_assert(2 * CFAR_TRAIN * 2 < 64, "cfar_sum_t too narrow");
+    dop_pow_t pow_buf[CFAR_COLS][N_PULSE];
+    cfar_sum_t lead_sum[N_PULSE], lag_sum[N_PULSE];
+    #pragma HLS ARRAY_PARTITION variable=pow_buf complete dim=1
+    #pragma HLS DEPENDENCE variable=pow_buf inter false
+    #pragma HLS DEPENDENCE variable=lead_sum inter false
+    #pragma HLS DEPENDENCE variable=lag_sum inter false
+
+    const bool en = (cfar_ctrl.scale != 0);
+    ap_uint<16> n_det = 0, n_drop = 0;
+
+    Cfar_Col_Loop: for (int c = 0; c < N_RANGE + CFAR_HALF; c++) {
+        const int k = c - CFAR_HALF;
+        // 本列被测单元的参考单元数
+        int lead_lo = k + CFAR_GUARD + 1, lead_hi = k + CFAR_HALF;
+        int lag_lo = k - CFAR_HALF, lag_hi = k - CFAR_GUARD - 1;
+        if (lead_hi > N_RANGE - 1) lead_hi = N_RANGE - 1;
+        if (lag_lo < 0) lag_lo = 0;
+        int n_lead = lead_hi >= lead_lo ? lead_hi - lead_lo + 1 : 0;
+        int n_lag = lag_hi >= lag_lo ? lag_hi - lag_lo + 1 : 0;
+        ap_uint<8> n_ref = n_lead + n_lag;
+
+        // 缓存列号 (模 CFAR_COLS)
+        const int i_new = c % CFAR_COLS;
+        const int i_lead_out = (c + CFAR_COLS - CFAR_TRAIN) % CFAR_COLS;              // c - T
+        const int i_lag_in = (c + CFAR_COLS - CFAR_HALF - CFAR_GUARD - 1) % CFAR_COLS; // k - G - 1
+        const int i_lag_out = (c + CFAR_COLS - 2 * CFAR_HALF - 1) % CFAR_COLS;        // k - HALF - 1
+        const int i_cut = (c + CFAR_COLS - CFAR_HALF) % CFAR_COLS;                    // k
+
+        Cfar_Dop_Loop: for (int p = 0; p < N_PULSE; p++) {
+            #pragma HLS PIPELINE II=1
+            dop_pow_t pw = 0;
+            if (c < N_RANGE) {
+                complex_t v = det_tap.read();
+                pw = (dop_pow_t)(v.real() * v.real()) + (dop_pow_t)(v.imag() * v.imag());
+            }
+            cfar_sum_t lead = (c == 0) ? cfar_sum_t(0) : lead_sum[p];
+            cfar_sum_t lag = (c == 0) ? cfar_sum_t(0) : lag_sum[p];
+            lead += pw;
+            if (c >= CFAR_TRAIN) lead -= pow_buf[i_lead_out][p];
+            if (k - CFAR_GUARD - 1 >= 0) lag += pow_buf[i_lag_in][p];
+            if (k - CFAR_HALF - 1 >= 0) lag -= pow_buf[i_lag_out][p];
+            lead_sum[p] = lead;
+            lag_sum[p] = lag;
+
+            if (k >= 0) {
+                dop_pow_t cut = (CFAR_HALF == 0) ? pw : pow_buf[i_cut][p];
+                bool hit = en && (cut * n_ref > cfar_ctrl.scale * (lead + lag));
+                if (hit) {
+                    if (n_det < CFAR_MAX_DET) {
+                        axis_det_t d;
+                        d.data.range(15, 0) = k;
+                        d.data.range(31, 16) = p;
+                        d.data.range(63, 32) = cut.range(31, 0);
+                        d.last = 0;
+                        d.keep = -1;
+                        d.strb = -1;
+                        det_output.write(d);
+                        n_det++;
+                    } else {
+                        n_drop++;
+                    }
+                }
+            }
+            pow_buf[i_new][p] = pw;
+        }
+    }
+
+    axis_det_t t;
+    t.data.range(31, 0) = DET_TRAILER_MAGIC;
+    t.data.range(47, 32) = n_det;
+    t.data.range(63, 48) = n_drop;
+    t.last = 1;
+    t.keep = -1;
+    t.strb = -1;
+    det_output.write(t);
+}
+
+// =========================================================
+// [Phase 2 Logic] 单个长时间运行的 Dataflow 区域
+// 读矩阵 / 多普勒 FFT / 输出三个任务各自在内部遍历所有列，
+// 列与列之间没有 Dataflow 重启和 FFT 排空，总时间约 N_RANGE*N_PULSE + FFT 延迟
+// =========================================================
+static void run_phase2_stream(ct_word_t mem_matrix[N_PULSE][CT_WORDS],
+                              ct_exp_t ct_exp[N_PULSE],
+                              const dop_win_t dop_win[N_PULSE],
+                              stream_rd_t &output,
+                              radar_ctrl_t ctrl,
+                              ap_uint<32> &dbg_in,
+                              ap_uint<32> &dbg_out) {
+    #pragma HLS INLINE off
+    #pragma HLS DATAFLOW
+
+    stream_dp_t fft_in_strm;
+    stream_dp_t fft_out_strm;
+    stream_internal_t no_tap;
+    #pragma HLS STREAM variable=fft_in_strm  depth=128 type=fifo
+    #pragma HLS STREAM variable=fft_out_strm depth=128 type=fifo
+
+    p2_matrix_reader(mem_matrix, ct_exp, dop_win, ctrl, fft_in_strm, dbg_in);
+    doppler_est_stream(fft_in_strm, fft_out_strm);
+    p2_output_writer<false>(fft_out_strm, output, no_tap, ctrl, dbg_out);
+}
+
+// =========================================================
+// [Phase 2 子带] DFT 组：dop_bins <= DOP_BAND_MAX_BINS 时代替多普勒 FFT
+// 按行 (脉冲) 读矩阵，同一脉冲的 N_RANGE 个距离门共用一组旋转因子 W^(k*p)，
+// 每个距离门的 DOP_BAND_MAX_BINS 个累加器按 bin 完全分割，所有 bin 同一周期更新，II=1
+// 只读前 n_pulse 行 (补零部分对 DFT 没有贡献)，总周期约 n_pulse * N_RANGE
+// 结果与 FFT 同一刻度：定点版本按 DOP_FFT_SCH 的总移位缩放，浮点版本不缩放
+// =========================================================
+struct dop_band_vec_t {
+    dp_complex_t bin[DOP_BAND_MAX_BINS];
+};
+
+// 旋转因子表即 r=1 的 exp(+j*2*pi*k/N_PULSE)，使用时取共轭
+static constexpr coeff_gen::table_t<N_PULSE> DOP_BAND_TW_TABLE =
+    coeff_gen::make_sdft_twiddle<N_PULSE>(1.0);
+static const std::complex<dop_band_tw_t> (&DOP_BAND_TW_ROM)[N_PULSE] =
+    coeff_gen::rom<std::complex<dop_band_tw_t>, N_PULSE, DOP_BAND_TW_TABLE,
+                   std::make_index_sequence<N_PULSE>>::table;
+
+static dp_data_t dop_band_scale(dop_band_acc_t s) {
+#ifdef RADAR_FLOAT_DATAPATH
+    return s;
+#else
+    return dp_data_t(s >> (RD_DP_SHIFT - PC_DP_SHIFT));
+#endif
+}
+
+static void p2_band_dft(ct_word_t mem_matrix[N_PULSE][CT_WORDS],
+                        ct_exp_t ct_exp[N_PULSE],
+                        const dop_win_t dop_win[N_PULSE],
+                        radar_ctrl_t ctrl,
+                        hls::stream<dop_band_vec_t> &vec_out,
+                        ap_uint<32> &dbg_cnt) {
+    #pragma HLS INLINE off
+    static dop_band_acc_t acc_re[DOP_BAND_MAX_BINS][N_RANGE];
+    static dop_band_acc_t acc_im[DOP_BAND_MAX_BINS][N_RANGE];
+    #pragma HLS ARRAY_PARTITION variable=acc_re complete dim=1
+    #pragma HLS ARRAY_PARTITION variable=acc_im complete dim=1
+
+    const int n_pulse = radar_ctrl_pulses(ctrl);
+    const bool win_en = ctrl.win_en;
+    ap_uint<32> cnt = 0;
+    Band_Pulse_Loop: for (int p = 0; p < n_pulse; p++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=N_PULSE
+        // 本脉冲用到的旋转因子
+        dop_band_tw_t w_re[DOP_BAND_MAX_BINS], w_im[DOP_BAND_MAX_BINS];
+        #pragma HLS ARRAY_PARTITION variable=w_re complete
+        #pragma HLS ARRAY_PARTITION variable=w_im complete
+        Band_Tw_Loop: for (int i = 0; i < DOP_BAND_MAX_BINS; i++) {
+            std::complex<dop_band_tw_t> w = DOP_BAND_TW_ROM[(radar_ctrl_fft_bin(ctrl, i) * p) % N_PULSE];
+            w_re[i] = w.real();
+            w_im[i] = w.imag();
+        }
+
+        Band_Gate_Loop: for (int r = 0; r < N_RANGE; r++) {
+            #pragma HLS PIPELINE II=1
+            dp_complex_t x = dop_load_cell(mem_matrix, ct_exp, dop_win, n_pulse, win_en, p, r);
+            cnt++;
+            dop_band_vec_t vec;
+            Band_Bin_Loop: for (int i = 0; i < DOP_BAND_MAX_BINS; i++) {
+                #pragma HLS UNROLL
+                // x * conj(w)
+                dop_band_acc_t s_re = (p == 0) ? dop_band_acc_t(0) : acc_re[i][r];
+                dop_band_acc_t s_im = (p == 0) ? dop_band_acc_t(0) : acc_im[i][r];
+                s_re += x.real() * w_re[i] + x.imag() * w_im[i];
+                s_im += x.imag() * w_re[i] - x.real() * w_im[i];
+                acc_re[i][r] = s_re;
+                acc_im[i][r] = s_im;
+                vec.bin[i] = dp_complex_t(dop_band_scale(s_re), dop_band_scale(s_im));
+            }
+            if (p == n_pulse - 1) vec_out.write(vec);
+        }
+    }
+    dbg_cnt = cnt;
+}
+
+// 子带输出：每个距离门 dop_bins 个单元
+static void p2_band_writer(hls::stream<dop_band_vec_t> &vec_in,
+                           stream_rd_t &output,
+                           radar_ctrl_t ctrl,
+                           ap_uint<32> &dbg_cnt) {
+    #pragma HLS INLINE off
+    const int n_bins = radar_ctrl_dop_bins(ctrl);
+    axis_rd_t out_pkt;
+    int slot = 0;
+    ap_uint<32> cnt = 0;
+    dop_band_vec_t vec;
+    Band_Wr_Loop: for (int i = 0; i < N_RANGE * n_bins; i++) {
+        #pragma HLS LOOP_TRIPCOUNT min=N_RANGE max=N_RANGE*DOP_BAND_MAX_BINS
+        #pragma HLS PIPELINE II=1
+        const int r = i / n_bins;
+        const int j = i % n_bins;
+        if (j == 0) vec = vec_in.read();
+        bool gate_end = (j == n_bins - 1);
+        rd_push_cell(output, out_pkt, slot, dp_to_fixed<RD_DP_SHIFT>(vec.bin[j]), gate_end,
+                     (r == N_RANGE - 1) && gate_end);
+        cnt++;
+    }
+    dbg_cnt = cnt;
+}
+
+static void run_phase2_band(ct_word_t mem_matrix[N_PULSE][CT_WORDS],
+                            ct_exp_t ct_exp[N_PULSE],
+                            const dop_win_t dop_win[N_PULSE],
+                            stream_rd_t &output,
+                            radar_ctrl_t ctrl,
+                            ap_uint<32> &dbg_in,
+                            ap_uint<32> &dbg_out) {
+    #pragma HLS INLINE off
+    #pragma HLS DATAFLOW
+
+    // 最后一行时每周期产出一个距离门，输出每门要 dop_bins 个周期，深度取 N_RANGE 不反压 DFT 组
+    hls::stream<dop_band_vec_t> vec_strm;
+    #pragma HLS STREAM variable=vec_strm depth=N_RANGE type=fifo
+
+    p2_band_dft(mem_matrix, ct_exp, dop_win, ctrl, vec_strm, dbg_in);
+    p2_band_writer(vec_strm, output, ctrl, dbg_out);
+}
+
+// 带检测：输出任务抄送一份给 CFAR，检测与 RD 输出在同一 Dataflow 区域内并行
+static void run_phase2_stream_det(ct_word_t mem_matrix[N_PULSE][CT_WORDS],
+                                  ct_exp_t ct_exp[N_PULSE],
+                                  const dop_win_t dop_win[N_PULSE],
+                                  stream_rd_t &output,
+                                  stream_det_t &det_output,
+                                  radar_ctrl_t ctrl,
+                                  cfar_ctrl_t cfar_ctrl,
+                                  ap_uint<32> &dbg_in,
+                                  ap_uint<32> &dbg_out) {
+    #pragma HLS INLINE off
+    #pragma HLS DATAFLOW
+
+    stream_dp_t fft_in_strm;
+    stream_dp_t fft_out_strm;
+    stream_internal_t det_tap;
+    #pragma HLS STREAM variable=fft_in_strm  depth=128 type=fifo
+    #pragma HLS STREAM variable=fft_out_strm depth=128 type=fifo
+    #pragma HLS STREAM variable=det_tap      depth=128 type=fifo
+
+    p2_matrix_reader(mem_matrix, ct_exp, dop_win, ctrl, fft_in_strm, dbg_in);
+    doppler_est_stream(fft_in_strm, fft_out_strm);
+    p2_output_writer<true>(fft_out_strm, output, det_tap, ctrl, dbg_out);
+    p2_cfar_detect(det_tap, det_output, cfar_ctrl);
+}
+
+#ifndef CT_COMPRESS
 // =========================================================
 // [Phase 2 Helper] RAM -> Stream (带调试计数)
 // =========================================================
-static void load_buff_to_stream(complex_t buff[N_PULSE],
-                                hls::stream<complex_t> &out_strm,
+static void load_buff_to_stream(dp_complex_t buff[N_PULSE],
+                                stream_dp_t &out_strm,
                                 ap_uint<32> &dbg_cnt) {
     #pragma HLS INLINE off
     for (int i = 0; i < N_PULSE; i++) {
@@ -59,8 +670,8 @@ static void load_buff_to_stream(complex_t buff[N_PULSE],
 // =========================================================
 // [Phase 2 Helper] Stream -> RAM (带调试计数)
 // =========================================================
-static void store_stream_to_buff(hls::stream<complex_t> &in_strm,
-                                 complex_t buff[N_PULSE],
+static void store_stream_to_buff(stream_dp_t &in_strm,
+                                 dp_complex_t buff[N_PULSE],
                                  ap_uint<32> &dbg_cnt) {
     #pragma HLS INLINE off
     for (int i = 0; i < N_PULSE; i++) {
@@ -71,10 +682,15 @@ static void store_stream_to_buff(hls::stream<complex_t> &in_strm,
 }
 
 // =========================================================
-// [Phase 2 Logic] 单列处理 Dataflow 函数 (PIPO 方案)
+// [多普勒优先] 单列处理 Dataflow 函数 (PIPO 方案)
+// 结果要原位写回 mem_matrix，不能与读矩阵放在同一个 Dataflow 区域，
+// 因此保留逐列处理：每列处理完后由 store_column_to_matrix 写回
 // =========================================================
-static void process_single_column(complex_t mem_matrix[N_PULSE][N_RANGE],
-                                  stream_out_t &output,
+static void process_single_column(ct_word_t mem_matrix[N_PULSE][CT_WORDS],
+                                  ct_exp_t ct_exp[N_PULSE],
+                                  const dop_win_t dop_win[N_PULSE],
+                                  stream_dp_t &dm_strm,
+                                  radar_ctrl_t ctrl,
                                   int r,
                                   ap_uint<32> &dbg_in,
                                   ap_uint<32> &dbg_out) {
@@ -82,21 +698,23 @@ static void process_single_column(complex_t mem_matrix[N_PULSE][N_RANGE],
     #pragma HLS DATAFLOW
 
     // 1. 物理存储 RAM (Ping-Pong)
-    complex_t buff_in[N_PULSE];
-    complex_t buff_out[N_PULSE];
+    dp_complex_t buff_in[N_PULSE];
+    dp_complex_t buff_out[N_PULSE];
     #pragma HLS BIND_STORAGE variable=buff_in type=ram_2p impl=bram
     #pragma HLS BIND_STORAGE variable=buff_out type=ram_2p impl=bram
 
     // 2. 连接 FFT 的内部流 (给足 128 深度以防万一)
-    hls::stream<complex_t> fft_in_strm;
-    hls::stream<complex_t> fft_out_strm;
+    stream_dp_t fft_in_strm;
+    stream_dp_t fft_out_strm;
     #pragma HLS STREAM variable=fft_in_strm  depth=128 type=fifo
     #pragma HLS STREAM variable=fft_out_strm depth=128 type=fifo
 
-    // Stage A: Matrix -> Buffer
+    // Stage A: Matrix -> Buffer (补零 + 加窗)
+    int n_pulse = radar_ctrl_pulses(ctrl);
+    bool win_en = ctrl.win_en;
     for (int p = 0; p < N_PULSE; p++) {
         #pragma HLS PIPELINE II=1
-        buff_in[p] = mem_matrix[p][r];
+        buff_in[p] = dop_load_cell(mem_matrix, ct_exp, dop_win, n_pulse, win_en, p, r);
     }
 
     // Stage B: Buffer -> Stream (埋点)
@@ -108,71 +726,577 @@ static void process_single_column(complex_t mem_matrix[N_PULSE][N_RANGE],
     // Stage D: Stream -> Buffer (埋点)
     store_stream_to_buff(fft_out_strm, buff_out, dbg_out);
 
-    // Stage E: Buffer -> Output
+    // Stage E: Buffer -> 写回流 (dop_shift 时按 p ^ (N_PULSE/2) 读 buff_out，零多普勒居中)
     for (int p = 0; p < N_PULSE; p++) {
         #pragma HLS PIPELINE II=1
-        complex_t val = buff_out[p];
-        axis_out_t out_pkt;
-        out_pkt.data.re = val.real();
-        out_pkt.data.im = val.imag();
-        out_pkt.last = (r == N_RANGE - 1) && (p == N_PULSE - 1);
-        out_pkt.keep = -1;
-        out_pkt.strb = -1;
-        output.write(out_pkt);
+        dm_strm.write(buff_out[ctrl.dop_shift ? (p ^ (N_PULSE / 2)) : p]);
     }
 }
 
 // =========================================================
-// Phase 2 循环驱动
+// [Phase 2 Helper] 多普勒优先：Doppler 结果写回矩阵第 r 列
+// 该列的脉压数据已在 Stage A 读走，可以原位覆盖
 // =========================================================
-static void run_phase2_doppler(complex_t mem_matrix[N_PULSE][N_RANGE],
-                               stream_out_t &output,
+static void store_column_to_matrix(stream_dp_t &dm_strm,
+                                   ct_word_t mem_matrix[N_PULSE][CT_WORDS],
+                                   int r) {
+    #pragma HLS INLINE off
+    for (int d = 0; d < N_PULSE; d++) {
+        #pragma HLS PIPELINE II=1
+        mem_matrix[d][r] = dm_strm.read();
+    }
+}
+
+// =========================================================
+// [Phase 3] 多普勒优先输出：Phase 2 之后再按行读一遍整张 RD 图
+// 这是独立的后处理遍历，不是 Phase 2 的输出寻址：多普勒优先的第一个输出单元要等最后一列 FFT 完成，
+// 流式输出做不到，只能整张图写回 mem_matrix 再转置读出。代价 (对比距离优先的流式 Phase 2)：
+//   - mem_matrix 访问 3 遍 (读列、写回列、按行读出)，距离优先只读 1 遍
+//   - Phase 2 逐列处理，每列至少 4*N_PULSE 个周期 (读列、FFT 整帧延迟、出缓存、写回)，不能首尾相接
+//   - 本遍历再加 dop_bins * N_RANGE 个周期
+// 合计至少为距离优先 (N_RANGE * N_PULSE + 一次 FFT 延迟) 的 5 倍；需要高帧率时用距离优先，
+// 主机按帧头 bit8 寻址即可 (radar_rdpost 两种顺序都能读)
+// =========================================================
+static void doppler_major_post_pass(ct_word_t mem_matrix[N_PULSE][CT_WORDS],
+                                    stream_rd_t &output,
+                                    radar_ctrl_t ctrl) {
+    #pragma HLS INLINE off
+    // 矩阵各行已按 dop_shift 排好，子带只需从 dop_first 起读 dop_bins 行
+    const int n_bins = radar_ctrl_dop_bins(ctrl);
+    const int first = radar_ctrl_dop_first(ctrl);
+    axis_rd_t out_pkt;
+    int slot = 0;
+    Dm_Row_Loop: for (int j = 0; j < n_bins; j++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=N_PULSE
+        const int d = (first + j) % N_PULSE;
+        Dm_Col_Loop: for (int r = 0; r < N_RANGE; r++) {
+            #pragma HLS PIPELINE II=1
+            bool row_end = (r == N_RANGE - 1);
+            rd_push_cell(output, out_pkt, slot, dp_to_fixed<RD_DP_SHIFT>(mem_matrix[d][r]),
+                         row_end, (j == n_bins - 1) && row_end);
+        }
+    }
+}
+// =========================================================
+// [多普勒优先] 逐列处理 + 写回
+// =========================================================
+static void run_phase2_doppler_major(ct_word_t mem_matrix[N_PULSE][CT_WORDS],
+                                     ct_exp_t ct_exp[N_PULSE],
+                                     const dop_win_t dop_win[N_PULSE],
+                                     radar_ctrl_t ctrl,
+                                     ap_uint<32> &dbg_in,
+                                     ap_uint<32> &dbg_out) {
+    #pragma HLS INLINE off
+    stream_dp_t dm_strm;
+    #pragma HLS STREAM variable=dm_strm depth=128 type=fifo
+
+    Doppler_Outer_Loop: for (int r = 0; r < N_RANGE; r++) {
+        process_single_column(mem_matrix, ct_exp, dop_win, dm_strm, ctrl, r, dbg_in, dbg_out);
+        store_column_to_matrix(dm_strm, mem_matrix, r);
+    }
+}
+#endif
+
+// =========================================================
+// [Phase 2 前] 帧头：帧计数 + CPI 内各脉冲元数据
+// =========================================================
+static void emit_frame_header(stream_rd_t &output,
+                              pulse_meta_t meta_tbl[N_PULSE],
+                              ap_uint<32> frame_cnt,
+                              radar_ctrl_t ctrl,
+                              ap_uint<32> tap_drop) {
+    #pragma HLS INLINE off
+    ap_uint<32> flags = frame_hdr_flags(meta_tbl, ctrl);
+    ap_uint<32> band = frame_hdr_band(ctrl);
+    ap_uint<32> rx_err = frame_hdr_rx_err(meta_tbl, ctrl);
+
+    axis_rd_t hdr_pkt;
+    int slot = 0;
+    Hdr_Loop: for (int k = 0; k < FRAME_HDR_WORDS; k++) {
+        #pragma HLS PIPELINE II=1
+        rd_beat_set_word(hdr_pkt, slot, frame_hdr_word(k, frame_cnt, flags, band, rx_err, meta_tbl, tap_drop));
+        if (slot == OUT_CELLS_PER_BEAT - 1) {
+            hdr_pkt.last = 0;
+            hdr_pkt.keep = -1;
+            hdr_pkt.strb = -1;
+            output.write(hdr_pkt);
+            slot = 0;
+        } else {
+            slot++;
+        }
+    }
+}
+
+#ifdef RADAR_SHARED_FFT
+// =========================================================
+// [共享 FFT] 单帧变换：缓存 -> FFT 核 -> 缓存，读入 / 变换 / 写出在帧内首尾相接
+// 距离向与多普勒向点数相同，统一用 fft_config；方向与缩放调度随配置字逐帧给出
+// =========================================================
+static_assert(N_RANGE == N_PULSE && doppler_fft_config::max_nfft == fft_config::max_nfft,
+              "RADAR_SHARED_FFT runs range and Doppler transforms on one fixed-length core");
+
+static void shared_fft_core(stream_dp_t &in_strm, stream_dp_t &out_strm, bool fwd, unsigned sch) {
+    #pragma HLS INLINE off
+    hls::stream<hls::ip_fft::config_t<fft_config>> cfg_strm;
+    hls::stream<hls::ip_fft::status_t<fft_config>> sts_strm;
+    #pragma HLS STREAM variable=cfg_strm depth=2
+    #pragma HLS STREAM variable=sts_strm depth=2
+
+    cfg_strm.write(radar_fft_cfg<fft_config>(fwd, sch));
+    radar_fft<fft_config>(in_strm, out_strm, sts_strm, cfg_strm);
+    hls::ip_fft::status_t<fft_config> stat;
+    sts_strm.read(stat);
+}
+
+static void shared_fft_frame(dp_complex_t x[N_PULSE],
+                             dp_complex_t y[N_PULSE],
+                             bool fwd,
+                             unsigned sch,
+                             ap_uint<32> &dbg_in,
+                             ap_uint<32> &dbg_out) {
+    #pragma HLS INLINE off
+    #pragma HLS DATAFLOW
+
+    stream_dp_t fft_in_strm;
+    stream_dp_t fft_out_strm;
+    #pragma HLS STREAM variable=fft_in_strm  depth=128 type=fifo
+    #pragma HLS STREAM variable=fft_out_strm depth=128 type=fifo
+
+    load_buff_to_stream(x, fft_in_strm, dbg_in);
+    shared_fft_core(fft_in_strm, fft_out_strm, fwd, sch);
+    store_stream_to_buff(fft_out_strm, y, dbg_out);
+}
+
+// =========================================================
+// [共享 FFT] 整个 CPI 的帧序列：Phase 1 与 Phase 2 在同一函数内，FFT 核只有一个实例
+// Phase 1 (每个输入脉冲两帧)：正变换 PC_FFT_SCH -> 乘匹配滤波系数 -> 逆变换 PC_IFFT_SCH ->
+//   预积累 (与 presum_pulses 同样的运算) 并写入矩阵第 m/K 行
+// Phase 2 (每个距离门一帧)：按列读矩阵 (补零 + 加窗) -> 多普勒 FFT DOP_FFT_SCH ->
+//   距离优先直接输出本列选中的 bin，多普勒优先写回矩阵第 r 列 (已按 dop_shift 排序)，最后按行读出
+// 窄子带 (dop_bins <= DOP_BAND_MAX_BINS) 仍由 DFT 组完成，Phase 2 不占用 FFT 核
+// 这一构建只为省资源，不含短码 FIR 核：ctrl.pc_fir_taps 被忽略，始终为 FFT 匹配滤波
+// =========================================================
+static void run_shared_fft_cpi(stream_in_t &input,
+                               ct_word_t mem_matrix[N_PULSE][CT_WORDS],
+                               ct_exp_t ct_exp[N_PULSE],
+                               pulse_meta_t meta_tbl[N_PULSE],
+                               const dop_win_t dop_win[N_PULSE],
+                               stream_rd_t &output,
+                               radar_ctrl_t ctrl,
+                               ap_uint<32> frame_cnt,
                                ap_uint<32> &dbg_in,
                                ap_uint<32> &dbg_out) {
     #pragma HLS INLINE off
-    Doppler_Outer_Loop: for (int r = 0; r < N_RANGE; r++) {
-        process_single_column(mem_matrix, output, r, dbg_in, dbg_out);
+    #pragma HLS ALLOCATION function instances=shared_fft_frame limit=1
+
+    dp_complex_t x[N_PULSE], y[N_PULSE];
+    presum_acc_t acc_re[N_RANGE], acc_im[N_RANGE];
+
+    const int n_pulse = radar_ctrl_pulses(ctrl);
+    const int log2k = radar_ctrl_presum(ctrl);
+    const int k_last = (1 << log2k) - 1;
+    ap_uint<16> phase = 0;
+    ap_uint<32> pc_in = 0, pc_out = 0;   // Phase 1 的帧不计入调试计数
+    rx_sync_t sync;
+    rx_sync_init(sync, ctrl.tlast_pulse);
+
+    Sh_Pulse_Loop: for (int m = 0; m < (n_pulse << log2k); m++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=PRESUM_MAX_PULSES
+        pulse_meta_t meta;
+        pc_shared_load(input, x, meta, sync, m == (n_pulse << log2k) - 1);
+        shared_fft_frame(x, y, 1, PC_FFT_SCH, pc_in, pc_out);
+        pc_shared_match(y, x);
+        shared_fft_frame(x, y, 0, PC_IFFT_SCH, pc_in, pc_out);
+
+        // 预积累 + 存储：每组保存首个脉冲的元数据，rx_err 取组内的或
+        const int j = m & k_last;
+        const int row = m >> log2k;
+        if (j == 0) meta_tbl[row] = meta;
+        else meta_tbl[row].rx_err |= meta.rx_err;
+        const std::complex<presum_nco_t> lo = PRESUM_NCO_ROM[phase.range(15, 16 - PRESUM_NCO_LUT_BITS)];
+        Sh_Store_Loop: for (int r = 0; r < N_RANGE; r++) {
+            #pragma HLS PIPELINE II=1
+            presum_acc_t re, im;
+            presum_mix(y[r], lo, ctrl.presum_fcw != 0, re, im);
+            if (j != 0) {
+                re += acc_re[r];
+                im += acc_im[r];
+            }
+            if (j == k_last) {
+                mem_matrix[row][r] = dp_complex_t(presum_avg(re, log2k), presum_avg(im, log2k));
+            } else {
+                acc_re[r] = re;
+                acc_im[r] = im;
+            }
+        }
+        phase += ctrl.presum_fcw;
+    }
+
+    // 帧头先于 RD 数据输出
+    emit_frame_header(output, meta_tbl, frame_cnt, ctrl, 0);
+
+    if (!ctrl.dop_major && radar_ctrl_dop_bins(ctrl) <= DOP_BAND_MAX_BINS) {
+        run_phase2_band(mem_matrix, ct_exp, dop_win, output, ctrl, dbg_in, dbg_out);
+        return;
+    }
+
+    const bool win_en = ctrl.win_en;
+    const int n_bins = radar_ctrl_dop_bins(ctrl);
+    axis_rd_t out_pkt;
+    int slot = 0;
+    dbg_in = 0;
+    dbg_out = 0;
+    Sh_Col_Loop: for (int r = 0; r < N_RANGE; r++) {
+        Sh_Col_Load: for (int p = 0; p < N_PULSE; p++) {
+            #pragma HLS PIPELINE II=1
+            x[p] = dop_load_cell(mem_matrix, ct_exp, dop_win, n_pulse, win_en, p, r);
+        }
+        shared_fft_frame(x, y, 1, DOP_FFT_SCH, dbg_in, dbg_out);
+        if (ctrl.dop_major) {
+            Sh_Col_Store: for (int d = 0; d < N_PULSE; d++) {
+                #pragma HLS PIPELINE II=1
+                mem_matrix[d][r] = y[ctrl.dop_shift ? (d ^ (N_PULSE / 2)) : d];
+            }
+        } else {
+            Sh_Col_Emit: for (int p = 0; p < n_bins; p++) {
+                #pragma HLS LOOP_TRIPCOUNT min=1 max=N_PULSE
+                #pragma HLS PIPELINE II=1
+                bool col_end = (p == n_bins - 1);
+                rd_push_cell(output, out_pkt, slot, dp_to_fixed<RD_DP_SHIFT>(y[radar_ctrl_fft_bin(ctrl, p)]),
+                             col_end, (r == N_RANGE - 1) && col_end);
+            }
+        }
     }
+    if (ctrl.dop_major) doppler_major_post_pass(mem_matrix, output, ctrl);
 }
+#endif
 
 // =========================================================
-// 顶层函数
+// [仅脉压] 脉压结果直接打包输出，每个脉冲一个 TLAST 包
 // =========================================================
-void radar_top(stream_in_t &input,
-               stream_out_t &output,
-               ap_uint<32> *dbg_fft_in_cnt,
-               ap_uint<32> *dbg_fft_out_cnt)
-{
-    #pragma HLS INTERFACE axis port=input
-    #pragma HLS INTERFACE axis port=output
-    #pragma HLS INTERFACE ap_none port=dbg_fft_in_cnt
-    #pragma HLS INTERFACE ap_none port=dbg_fft_out_cnt
-    #pragma HLS INTERFACE ap_ctrl_hs port=return
+static void pc_output_writer(stream_out_t &pc_stream,
+                             stream_rd_t &output,
+                             int n_pulse,
+                             ap_uint<32> &dbg_cnt) {
+    #pragma HLS INLINE off
+    axis_rd_t out_pkt;
+    int slot = 0;
+    ap_uint<32> cnt = 0;
+    Pc_Pulse_Loop: for (int p = 0; p < n_pulse; p++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=N_PULSE
+        Pc_Range_Loop: for (int r = 0; r < N_RANGE; r++) {
+            #pragma HLS PIPELINE II=1
+            axis_out_t pkt = pc_stream.read();
+            bool pulse_end = (r == N_RANGE - 1);
+            rd_push_cell(output, out_pkt, slot, complex_t(pkt.data.re, pkt.data.im), pulse_end, pulse_end);
+            cnt++;
+        }
+    }
+    dbg_cnt = cnt;
+}
 
-    ap_uint<32> d_in = 0;
-    ap_uint<32> d_out = 0;
+static void run_pc_only(stream_in_t &input,
+                        stream_rd_t &output,
+                        stream_meta_t &meta_out,
+                        int n_pulse,
+                        bool tlast_per_pulse,
+                        ap_uint<32> &dbg_out) {
+    #pragma HLS INLINE off
+    #pragma HLS DATAFLOW
+
+    stream_out_t pc_stream;
+    #pragma HLS STREAM variable=pc_stream depth=16 type=fifo
+
+    pulse_compression_cpi(input, pc_stream, meta_out, n_pulse, tlast_per_pulse);
+    pc_output_writer(pc_stream, output, n_pulse, dbg_out);
+}
+
+// =========================================================
+// 按策略选择的处理级 (重载分派，未选中的级不会被实例化)
+// 只有脉压时没有多普勒 FFT：d_in 恒为 0，d_out 为实际输出的距离像单元数
+// =========================================================
+static void radar_stages_run(radar_stages_pc,
+                             stream_in_t &input,
+                             stream_rd_t &output,
+                             stream_meta_t &meta_out,
+                             stream_det_t &,
+                             stream_rd_t &,
+                             radar_ctrl_t ctrl,
+                             cfar_ctrl_t,
+                             tap_ctrl_t,
+                             const dop_win_t [N_PULSE],
+                             const pc_fir_tap_t [PC_FIR_MAX_TAPS],
+                             ap_uint<32> &d_in,
+                             ap_uint<32> &d_out) {
+    #pragma HLS INLINE
+    int n_pulse = radar_ctrl_pulses(ctrl);
+    d_in = 0;
+    run_pc_only(input, output, meta_out, n_pulse, ctrl.tlast_pulse, d_out);
+}
+
+template <bool DET, bool TAP>
+static void radar_stages_run(radar_stage_policy<true, DET, TAP>,
+                             stream_in_t &input,
+                             stream_rd_t &output,
+                             stream_meta_t &meta_out,
+                             stream_det_t &det_output,
+                             stream_rd_t &tap_output,
+                             radar_ctrl_t ctrl,
+                             cfar_ctrl_t cfar_ctrl,
+                             tap_ctrl_t tap_ctrl,
+                             const dop_win_t dop_win[N_PULSE],
+                             const pc_fir_tap_t pc_fir_tap[PC_FIR_MAX_TAPS],
+                             ap_uint<32> &d_in,
+                             ap_uint<32> &d_out) {
+    #pragma HLS INLINE
+#ifdef CT_COMPRESS
+    // 压缩存储无法原位写回 RD 结果，只支持距离优先
+    ctrl.dop_major = 0;
+#endif
+    // 检测级接在距离优先的流式输出上，CFAR 需要全部多普勒通道
+    if (DET) {
+        ctrl.dop_major = 0;
+        ctrl.dop_bins = 0;
+    }
 
-    static complex_t mem_matrix[N_PULSE][N_RANGE];
+    static ct_word_t mem_matrix[N_PULSE][CT_WORDS];
+    static ct_exp_t ct_exp[N_PULSE];
+    static pulse_meta_t meta_tbl[N_PULSE];
+    static ap_uint<32> frame_cnt = 0;
     #pragma HLS RESOURCE variable=mem_matrix core=RAM_2P_BRAM
+#ifndef CT_COMPRESS
     #pragma HLS ARRAY_PARTITION variable=mem_matrix cyclic factor=4 dim=2
+#endif
 
     printf(">> [DUT] Phase 1 Start (Dataflow)...\n");
 
-    // 【修改】Phase 1 循环：现在调用 Dataflow 封装函数
-    Pulse_Loop: for (int p = 0; p < N_PULSE; p++) {
-        // 这会让脉压和存储同时进行，不会因为 FIFO 满而死锁
-        process_single_pulse(input, mem_matrix, p);
+    // Phase 1：整个 CPI 一次流过脉压、预积累与存储 (TAP 时脉压结果同时分叉到旁路口)
+    ap_uint<32> tap_drop = 0;
+    if (TAP) {
+        run_phase1_stream_tap(input, mem_matrix, ct_exp, meta_tbl, ctrl, pc_fir_tap, tap_output, meta_out, tap_ctrl,
+                              tap_drop);
+    } else {
+        run_phase1_stream(input, mem_matrix, ct_exp, meta_tbl, ctrl, pc_fir_tap);
     }
 
     printf(">> [DUT] Phase 1 Complete.\n");
 
     printf(">> [DUT] Phase 2 Start (Dataflow)...\n");
 
+    // 帧头先于 RD 数据输出
+    emit_frame_header(output, meta_tbl, frame_cnt, ctrl, tap_drop);
+    frame_cnt++;
+
     // Phase 2
-    run_phase2_doppler(mem_matrix, output, d_in, d_out);
+    if (DET) {
+        run_phase2_stream_det(mem_matrix, ct_exp, dop_win, output, det_output, ctrl, cfar_ctrl, d_in, d_out);
+    } else
+#ifndef CT_COMPRESS
+    if (ctrl.dop_major) {
+        // 多普勒优先：逐列处理写回矩阵，Phase 3 后处理再按行读出 (代价见 doppler_major_post_pass)
+        run_phase2_doppler_major(mem_matrix, ct_exp, dop_win, ctrl, d_in, d_out);
+        doppler_major_post_pass(mem_matrix, output, ctrl);
+    } else
+#endif
+    if (radar_ctrl_dop_bins(ctrl) <= DOP_BAND_MAX_BINS) {
+        // 窄子带：DFT 组代替多普勒 FFT
+        run_phase2_band(mem_matrix, ct_exp, dop_win, output, ctrl, d_in, d_out);
+    } else {
+        run_phase2_stream(mem_matrix, ct_exp, dop_win, output, ctrl, d_in, d_out);
+    }
+
+    printf(">> [DUT] Phase 2 Complete.\n");
+}
+
+#ifdef RADAR_SHARED_FFT
+// 共享 FFT 核：radar_top (脉压 + 多普勒，无检测 / 旁路) 改走单个帧序列，
+// 其余策略仍是上面的流式版本 (非模板重载优先匹配)
+static void radar_stages_run(radar_stages_pc_dop,
+                             stream_in_t &input,
+                             stream_rd_t &output,
+                             stream_meta_t &,
+                             stream_det_t &,
+                             stream_rd_t &,
+                             radar_ctrl_t ctrl,
+                             cfar_ctrl_t,
+                             tap_ctrl_t,
+                             const dop_win_t dop_win[N_PULSE],
+                             const pc_fir_tap_t [PC_FIR_MAX_TAPS],
+                             ap_uint<32> &d_in,
+                             ap_uint<32> &d_out) {
+    #pragma HLS INLINE
+    static ct_word_t mem_matrix[N_PULSE][CT_WORDS];
+    static ct_exp_t ct_exp[N_PULSE];
+    static pulse_meta_t meta_tbl[N_PULSE];
+    static ap_uint<32> frame_cnt = 0;
+    #pragma HLS RESOURCE variable=mem_matrix core=RAM_2P_BRAM
+    #pragma HLS ARRAY_PARTITION variable=mem_matrix cyclic factor=4 dim=2
+
+    printf(">> [DUT] Shared-FFT CPI Start...\n");
+    run_shared_fft_cpi(input, mem_matrix, ct_exp, meta_tbl, dop_win, output, ctrl, frame_cnt, d_in, d_out);
+    frame_cnt++;
+    printf(">> [DUT] Shared-FFT CPI Complete.\n");
+}
+#endif
+
+// =========================================================
+// 通用顶层模板
+// =========================================================
+template <class STAGES>
+void radar_top_t(stream_in_t &input,
+                 stream_rd_t &output,
+                 stream_meta_t &meta_out,
+                 stream_det_t &det_output,
+                 stream_rd_t &tap_output,
+                 radar_ctrl_t ctrl,
+                 cfar_ctrl_t cfar_ctrl,
+                 tap_ctrl_t tap_ctrl,
+                 const dop_win_t dop_win[N_PULSE],
+                 const pc_fir_tap_t pc_fir_tap[PC_FIR_MAX_TAPS],
+                 ap_uint<32> *dbg_fft_in_cnt,
+                 ap_uint<32> *dbg_fft_out_cnt)
+{
+    #pragma HLS INLINE
+    ap_uint<32> d_in = 0;
+    ap_uint<32> d_out = 0;
+
+    radar_stages_run(STAGES(), input, output, meta_out, det_output, tap_output, ctrl, cfar_ctrl, tap_ctrl,
+                     dop_win, pc_fir_tap, d_in, d_out);
 
     *dbg_fft_in_cnt = d_in;
     *dbg_fft_out_cnt = d_out;
+}
 
-    printf(">> [DUT] Phase 2 Complete.\n");
+template void radar_top_t<radar_stages_pc>(stream_in_t &, stream_rd_t &, stream_meta_t &, stream_det_t &,
+                                           stream_rd_t &, radar_ctrl_t, cfar_ctrl_t, tap_ctrl_t, const dop_win_t *,
+                                           const pc_fir_tap_t *, ap_uint<32> *, ap_uint<32> *);
+template void radar_top_t<radar_stages_pc_dop>(stream_in_t &, stream_rd_t &, stream_meta_t &, stream_det_t &,
+                                               stream_rd_t &, radar_ctrl_t, cfar_ctrl_t, tap_ctrl_t, const dop_win_t *,
+                                               const pc_fir_tap_t *, ap_uint<32> *, ap_uint<32> *);
+template void radar_top_t<radar_stages_pc_dop_det>(stream_in_t &, stream_rd_t &, stream_meta_t &, stream_det_t &,
+                                                   stream_rd_t &, radar_ctrl_t, cfar_ctrl_t, tap_ctrl_t, const dop_win_t *,
+                                                   const pc_fir_tap_t *, ap_uint<32> *, ap_uint<32> *);
+template void radar_top_t<radar_stages_pc_dop_tap>(stream_in_t &, stream_rd_t &, stream_meta_t &, stream_det_t &,
+                                                   stream_rd_t &, radar_ctrl_t, cfar_ctrl_t, tap_ctrl_t, const dop_win_t *,
+                                                   const pc_fir_tap_t *, ap_uint<32> *, ap_uint<32> *);
+
+// =========================================================
+// 顶层函数 (各部署选其一作为综合顶层)
+// =========================================================
+void radar_top(stream_in_t &input,
+               stream_rd_t &output,
+               radar_ctrl_t ctrl,
+               const dop_win_t dop_win[N_PULSE],
+               const pc_fir_tap_t pc_fir_tap[PC_FIR_MAX_TAPS],
+               ap_uint<32> *dbg_fft_in_cnt,
+               ap_uint<32> *dbg_fft_out_cnt)
+{
+    #pragma HLS INTERFACE axis port=input
+    #pragma HLS INTERFACE axis port=output
+    #pragma HLS INTERFACE ap_none port=ctrl
+    #pragma HLS INTERFACE bram port=dop_win
+    #pragma HLS INTERFACE bram port=pc_fir_tap
+    #pragma HLS INTERFACE ap_none port=dbg_fft_in_cnt
+    #pragma HLS INTERFACE ap_none port=dbg_fft_out_cnt
+    #pragma HLS INTERFACE ap_ctrl_hs port=return
+
+#if defined(RADAR_BACKEND_SW) && !defined(__SYNTHESIS__)
+    // 软件后端：C-sim / 实验室回放时直接走 CPU 浮点实现
+    radar_top_sw(input, output, ctrl, dop_win, pc_fir_tap, dbg_fft_in_cnt, dbg_fft_out_cnt);
+    return;
+#endif
+
+    stream_meta_t no_meta;
+    stream_det_t no_det;
+    stream_rd_t no_tap;
+    cfar_ctrl_t no_cfar;
+    no_cfar.scale = 0;
+    tap_ctrl_t no_tap_ctrl;
+    no_tap_ctrl.mode = 0;
+    no_tap_ctrl.decim_log2 = 0;
+    radar_top_t<radar_stages_pc_dop>(input, output, no_meta, no_det, no_tap, ctrl, no_cfar, no_tap_ctrl, dop_win,
+                                     pc_fir_tap, dbg_fft_in_cnt, dbg_fft_out_cnt);
+}
+
+void radar_top_pc(stream_in_t &input,
+                  stream_rd_t &output,
+                  stream_meta_t &meta_out,
+                  radar_ctrl_t ctrl)
+{
+    #pragma HLS INTERFACE axis port=input
+    #pragma HLS INTERFACE axis port=output
+    #pragma HLS INTERFACE axis port=meta_out
+    #pragma HLS INTERFACE ap_none port=ctrl
+    #pragma HLS INTERFACE ap_ctrl_hs port=return
+
+    stream_det_t no_det;
+    stream_rd_t no_tap;
+    cfar_ctrl_t no_cfar;
+    no_cfar.scale = 0;
+    tap_ctrl_t no_tap_ctrl;
+    no_tap_ctrl.mode = 0;
+    no_tap_ctrl.decim_log2 = 0;
+    ap_uint<32> d_in, d_out;
+    radar_top_t<radar_stages_pc>(input, output, meta_out, no_det, no_tap, ctrl, no_cfar, no_tap_ctrl, nullptr,
+                                 nullptr, &d_in, &d_out);
+}
+
+void radar_top_det(stream_in_t &input,
+                   stream_rd_t &output,
+                   stream_det_t &det_output,
+                   radar_ctrl_t ctrl,
+                   cfar_ctrl_t cfar_ctrl,
+                   const dop_win_t dop_win[N_PULSE],
+                   const pc_fir_tap_t pc_fir_tap[PC_FIR_MAX_TAPS],
+                   ap_uint<32> *dbg_fft_in_cnt,
+                   ap_uint<32> *dbg_fft_out_cnt)
+{
+    #pragma HLS INTERFACE axis port=input
+    #pragma HLS INTERFACE axis port=output
+    #pragma HLS INTERFACE axis port=det_output
+    #pragma HLS INTERFACE ap_none port=ctrl
+    #pragma HLS INTERFACE ap_none port=cfar_ctrl
+    #pragma HLS INTERFACE bram port=dop_win
+    #pragma HLS INTERFACE bram port=pc_fir_tap
+    #pragma HLS INTERFACE ap_none port=dbg_fft_in_cnt
+    #pragma HLS INTERFACE ap_none port=dbg_fft_out_cnt
+    #pragma HLS INTERFACE ap_ctrl_hs port=return
+
+    stream_meta_t no_meta;
+    stream_rd_t no_tap;
+    tap_ctrl_t no_tap_ctrl;
+    no_tap_ctrl.mode = 0;
+    no_tap_ctrl.decim_log2 = 0;
+    radar_top_t<radar_stages_pc_dop_det>(input, output, no_meta, det_output, no_tap, ctrl, cfar_ctrl, no_tap_ctrl,
+                                         dop_win, pc_fir_tap, dbg_fft_in_cnt, dbg_fft_out_cnt);
+}
+
+void radar_top_tap(stream_in_t &input,
+                   stream_rd_t &output,
+                   stream_rd_t &tap_output,
+                   stream_meta_t &meta_out,
+                   radar_ctrl_t ctrl,
+                   tap_ctrl_t tap_ctrl,
+                   const dop_win_t dop_win[N_PULSE],
+                   const pc_fir_tap_t pc_fir_tap[PC_FIR_MAX_TAPS],
+                   ap_uint<32> *dbg_fft_in_cnt,
+                   ap_uint<32> *dbg_fft_out_cnt)
+{
+    #pragma HLS INTERFACE axis port=input
+    #pragma HLS INTERFACE axis port=output
+    #pragma HLS INTERFACE axis port=tap_output
+    #pragma HLS INTERFACE axis port=meta_out
+    #pragma HLS INTERFACE ap_none port=ctrl
+    #pragma HLS INTERFACE ap_none port=tap_ctrl
+    #pragma HLS INTERFACE bram port=dop_win
+    #pragma HLS INTERFACE bram port=pc_fir_tap
+    #pragma HLS INTERFACE ap_none port=dbg_fft_in_cnt
+    #pragma HLS INTERFACE ap_none port=dbg_fft_out_cnt
+    #pragma HLS INTERFACE ap_ctrl_hs port=return
+
+    stream_det_t no_det;
+    cfar_ctrl_t no_cfar;
+    no_cfar.scale = 0;
+    radar_top_t<radar_stages_pc_dop_tap>(input, output, meta_out, no_det, tap_output, ctrl, no_cfar, tap_ctrl,
+                                         dop_win, pc_fir_tap, dbg_fft_in_cnt, dbg_fft_out_cnt);
 }
@@ -0,0 +1,150 @@
+#include "radar_defines.h"
+#include "radar_coeffs_gen.h"
+
+// =========================================================
+// 滑动 DFT 多普勒 (快速反应模式)
+// radar_top 要等 N_PULSE 个脉冲存满角转换矩阵才输出，延迟一整个 CPI；
+// 这里每个距离门维护一组递推 DFT，每来一个脉压脉冲就更新选定的 bin：
+//
+//   S_k(n) = W_k * (S_k(n-1) + x(n) - r^N * x(n-N)),   W_k = r * exp(+j*2*pi*k/N)
+//
+// 展开后 S_k(n) = sum_m r^(N-m) * x(n-N+1+m) * exp(-j*2*pi*k*m/N)，
+// 即最近 N_PULSE 个脉冲 (m=0 最老) 加权后的 N 点 DFT，r=1 时与 CPI 的多普勒 FFT 完全相同。
+// 每个距离门每脉冲只需 n_bins 次复数乘，FFT 需要一整列数据而这里不需要。
+// =========================================================
+
+static constexpr double SDFT_DAMP_R = 1.0 - 1.0 / (double)(1 << SDFT_DAMP_SHIFT);
+static constexpr coeff_gen::table_t<N_PULSE> SDFT_TW_TABLE =
+    coeff_gen::make_sdft_twiddle<N_PULSE>(SDFT_DAMP_R);
+static const sdft_tw_cplx_t (&SDFT_TW_ROM)[N_PULSE] =
+    coeff_gen::rom<sdft_tw_cplx_t, N_PULSE, SDFT_TW_TABLE,
+                   std::make_index_sequence<N_PULSE>>::table;
+static const sdft_tw_t SDFT_DAMP_RN = coeff_gen::pow_int(SDFT_DAMP_R, N_PULSE);
+
+static_assert(N_PULSE <= 256, "sdft_ctrl_t bin index is 8 bit");
+static_assert(SDFT_MAX_BINS <= N_PULSE, "SDFT_MAX_BINS exceeds N_PULSE");
+
+// =========================================================
+// 任务 B: 递推更新
+// 历史环形缓存保存最近 N_PULSE 个脉冲 (x(n-N) 从这里取出，同地址写入 x(n))
+// 累加器按 bin 完全分割，所有 bin 在同一周期并行更新，II=1
+// =========================================================
+static void sdft_update(stream_out_t &pc_in,
+                        hls::stream<sdft_vec_t> &vec_out,
+                        sdft_ctrl_t ctrl) {
+    #pragma HLS INLINE off
+    static complex_t hist[N_PULSE][N_RANGE];
+    static sdft_acc_t acc_re[SDFT_MAX_BINS][N_RANGE];
+    static sdft_acc_t acc_im[SDFT_MAX_BINS][N_RANGE];
+    #pragma HLS ARRAY_PARTITION variable=acc_re complete dim=1
+    #pragma HLS ARRAY_PARTITION variable=acc_im complete dim=1
+    static ap_uint<8> wr_ptr = 0;
+    static ap_uint<16> n_fill = 0;   // 复位后已进入窗口的脉冲数 (到 N_PULSE 为止)
+
+    if (ctrl.reset) {
+        wr_ptr = 0;
+        n_fill = 0;
+    }
+    bool full = (n_fill >= N_PULSE);
+
+    // 本脉冲用到的旋转因子
+    sdft_tw_t w_re[SDFT_MAX_BINS], w_im[SDFT_MAX_BINS];
+    #pragma HLS ARRAY_PARTITION variable=w_re complete
+    #pragma HLS ARRAY_PARTITION variable=w_im complete
+    Tw_Loop: for (int i = 0; i < SDFT_MAX_BINS; i++) {
+        sdft_tw_cplx_t w = SDFT_TW_ROM[ctrl.bin[i] % N_PULSE];
+        w_re[i] = w.real();
+        w_im[i] = w.imag();
+    }
+
+    Gate_Loop: for (int r = 0; r < N_RANGE; r++) {
+        #pragma HLS PIPELINE II=1
+        axis_out_t pkt = pc_in.read();
+        complex_t x_old = hist[wr_ptr][r];
+        hist[wr_ptr][r] = complex_t(pkt.data.re, pkt.data.im);
+
+        // 窗口未满时被移出的样点视为 0
+        sdft_acc_t d_re = pkt.data.re;
+        sdft_acc_t d_im = pkt.data.im;
+        if (full) {
+            d_re -= SDFT_DAMP_RN * x_old.real();
+            d_im -= SDFT_DAMP_RN * x_old.imag();
+        }
+
+        sdft_vec_t vec;
+        Bin_Loop: for (int i = 0; i < SDFT_MAX_BINS; i++) {
+            #pragma HLS UNROLL
+            sdft_acc_t s_re = ctrl.reset ? sdft_acc_t(0) : acc_re[i][r];
+            sdft_acc_t s_im = ctrl.reset ? sdft_acc_t(0) : acc_im[i][r];
+            s_re += d_re;
+            s_im += d_im;
+            sdft_acc_t n_re = s_re * w_re[i] - s_im * w_im[i];
+            sdft_acc_t n_im = s_re * w_im[i] + s_im * w_re[i];
+            acc_re[i][r] = n_re;
+            acc_im[i][r] = n_im;
+
+            // 输出缩放后饱和到 16 位 (未用的 bin 也照常计算，输出阶段丢弃)
+            n_re >>= SDFT_OUT_SHIFT;
+            n_im >>= SDFT_OUT_SHIFT;
+            ap_fixed<16, 1, AP_RND, AP_SAT> o_re = n_re;
+            ap_fixed<16, 1, AP_RND, AP_SAT> o_im = n_im;
+            vec.bin[i] = complex_t((fft_data_t)o_re, (fft_data_t)o_im);
+        }
+        vec_out.write(vec);
+    }
+
+    wr_ptr = (wr_ptr == N_PULSE - 1) ? ap_uint<8>(0) : ap_uint<8>(wr_ptr + 1);
+    if (!full) n_fill++;
+}
+
+// =========================================================
+// 任务 C: 输出 N_RANGE * n_bins 个单元，距离门优先 (r*n_bins + i)
+// 每个距离门末尾 flush 一次 beat，TLAST 在本脉冲最后一个单元
+// =========================================================
+static void sdft_output(hls::stream<sdft_vec_t> &vec_in,
+                        stream_rd_t &output,
+                        sdft_ctrl_t ctrl) {
+    #pragma HLS INLINE off
+    int n_bins = ctrl.n_bins;
+    if (n_bins < 1) n_bins = 1;
+    if (n_bins > SDFT_MAX_BINS) n_bins = SDFT_MAX_BINS;
+
+    axis_rd_t out_pkt;
+    int slot = 0;
+    sdft_vec_t vec;
+    Out_Gate_Loop: for (int r = 0; r < N_RANGE; r++) {
+        Out_Bin_Loop: for (int i = 0; i < n_bins; i++) {
+            #pragma HLS PIPELINE II=1
+            #pragma HLS LOOP_TRIPCOUNT min=1 max=SDFT_MAX_BINS
+            if (i == 0) vec = vec_in.read();
+            bool gate_end = (i == n_bins - 1);
+            rd_push_cell(output, out_pkt, slot, vec.bin[i], gate_end, (r == N_RANGE - 1) && gate_end);
+        }
+    }
+}
+
+// =========================================================
+// 顶层：一次调用 = 一个脉冲
+// 脉压 -> 递推更新 -> 输出 三级 Dataflow，脉冲结束后即得到该时刻的 RD 估计
+// meta_out 原样转出本脉冲的 TUSER 元数据，主机据此给输出打时间戳
+// =========================================================
+void radar_sdft_top(stream_in_t &input,
+                    stream_rd_t &output,
+                    stream_meta_t &meta_out,
+                    sdft_ctrl_t ctrl) {
+    #pragma HLS INTERFACE axis port=input
+    #pragma HLS INTERFACE axis port=output
+    #pragma HLS INTERFACE axis port=meta_out
+    #pragma HLS INTERFACE ap_none port=ctrl
+    #pragma HLS INTERFACE ap_ctrl_hs port=return
+    #pragma HLS DATAFLOW
+
+    stream_out_t pc_strm;
+    hls::stream<sdft_vec_t> vec_strm;
+    #pragma HLS STREAM variable=pc_strm  depth=16 type=fifo
+    #pragma HLS STREAM variable=vec_strm depth=16 type=fifo
+
+    pulse_compression(input, pc_strm, meta_out);
+    sdft_update(pc_strm, vec_strm, ctrl);
+    sdft_output(vec_strm, output, ctrl);
+}
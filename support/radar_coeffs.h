@@ -1,128 +0,0 @@
-{0.301201, -0.301201},
-{0.422036, -0.282139},
-{0.564964, -0.208023},
-{0.704100, -0.050182},
-{0.784539, 0.209447},
-{0.723273, 0.549377},
-{0.440213, 0.872713},
-{-0.065594, 0.997846},
-{-0.619838, 0.734847},
-{-0.863925, 0.078570},
-{-0.483222, -0.598064},
-{0.356556, -0.668318},
-{0.845863, 0.094652},
-{0.282149, 0.890686},
-{-0.712296, 0.556655},
-{-0.575369, -0.552367},
-{0.599688, -0.527409},
-{0.569826, 0.702865},
-{-0.710307, 0.542010},
-{-0.288695, -0.735968},
-{0.850450, 0.063932},
-{-0.365544, 0.832124},
-{-0.474461, -0.648042},
-{0.849857, 0.100648},
-{-0.603348, 0.659989},
-{0.040933, -0.794385},
-{0.472498, 0.763958},
-{-0.770887, -0.309383},
-{0.851207, 0.054263},
-{-0.802813, 0.340810},
-{0.707681, -0.419822},
-{-0.631891, 0.625407},
-{0.601749, -0.549176},
-{-0.631891, 0.625407},
-{0.707681, -0.419822},
-{-0.802813, 0.340810},
-{0.851207, 0.054263},
-{-0.770887, -0.309383},
-{0.472498, 0.763958},
-{0.040933, -0.794385},
-{-0.603348, 0.659989},
-{0.849857, 0.100648},
-{-0.474461, -0.648042},
-{-0.365544, 0.832124},
-{0.850450, 0.063932},
-{-0.288695, -0.735968},
-{-0.710307, 0.542010},
-{0.569826, 0.702865},
-{0.599688, -0.527409},
-{-0.575369, -0.552367},
-{-0.712296, 0.556655},
-{0.282149, 0.890686},
-{0.845863, 0.094652},
-{0.356556, -0.668318},
-{-0.483222, -0.598064},
-{-0.863925, 0.078570},
-{-0.619838, 0.734847},
-{-0.065594, 0.997846},
-{0.440213, 0.872713},
-{0.723273, 0.549377},
-{0.784539, 0.209447},
-{0.704100, -0.050182},
-{0.564964, -0.208023},
-{0.422036, -0.282139},
-{0.301201, -0.301201},
-{0.209199, -0.289978},
-{0.143385, -0.265281},
-{0.098024, -0.236822},
-{0.067386, -0.209447},
-{0.046857, -0.185132},
-{0.033091, -0.164364},
-{0.023792, -0.146948},
-{0.017436, -0.132445},
-{0.013027, -0.120372},
-{0.009918, -0.110285},
-{0.007689, -0.101813},
-{0.006062, -0.094652},
-{0.004855, -0.088562},
-{0.003946, -0.083351},
-{0.003252, -0.078867},
-{0.002713, -0.074993},
-{0.002292, -0.071631},
-{0.001957, -0.068706},
-{0.001690, -0.066156},
-{0.001475, -0.063932},
-{0.001300, -0.061994},
-{0.001157, -0.060307},
-{0.001041, -0.058846},
-{0.000946, -0.057587},
-{0.000869, -0.056513},
-{0.000806, -0.055609},
-{0.000756, -0.054862},
-{0.000717, -0.054263},
-{0.000688, -0.053805},
-{0.000668, -0.053482},
-{0.000656, -0.053289},
-{0.000652, -0.053225},
-{0.000656, -0.053289},
-{0.000668, -0.053482},
-{0.000688, -0.053805},
-{0.000717, -0.054263},
-{0.000756, -0.054862},
-{0.000806, -0.055609},
-{0.000869, -0.056513},
-{0.000946, -0.057587},
-{0.001041, -0.058846},
-{0.001157, -0.060307},
-{0.001300, -0.061994},
-{0.001475, -0.063932},
-{0.001690, -0.066156},
-{0.001957, -0.068706},
-{0.002292, -0.071631},
-{0.002713, -0.074993},
-{0.003252, -0.078867},
-{0.003946, -0.083351},
-{0.004855, -0.088562},
-{0.006062, -0.094652},
-{0.007689, -0.101813},
-{0.009918, -0.110285},
-{0.013027, -0.120372},
-{0.017436, -0.132445},
-{0.023792, -0.146948},
-{0.033091, -0.164364},
-{0.046857, -0.185132},
-{0.067386, -0.209447},
-{0.098024, -0.236822},
-{0.143385, -0.265281},
-{0.209199, -0.289978}
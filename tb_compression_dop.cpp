@@ -1,4 +1,5 @@
 #include "radar_defines.h"
+#include "radar_fft.h"
 #include <iostream>
 #include <fstream>
 #include <vector>
@@ -34,7 +35,7 @@ int main() {
 
     // 声明流
     stream_in_t input_stream("input_stream");
-    stream_out_t output_stream("output_stream");
+    stream_rd_t output_stream("output_stream");
 
     // 声明调试计数器变量 (用于监控死锁情况)
     ap_uint<32> debug_in_cnt = 0;
@@ -56,7 +57,7 @@ int main() {
 
     // 检查数据量
     int samples_per_frame = N_PULSE * N_RANGE;
-    if (data_buffer.size() < samples_per_frame) {
+    if (data_buffer.size() < (size_t)samples_per_frame) {
         cout << "WARNING: Input file has fewer samples than expected!" << endl;
     }
 
@@ -65,16 +66,44 @@ int main() {
     // ------------------------------------------------------
     // 运行 3 帧，让 HLS 能够计算 II (Initiation Interval)
     const int NUM_FRAMES = 3;
+    // 之后再跑 3 帧，依次验证 多普勒优先 / fftshift / 两者同时 的输出顺序
+    const int NUM_ORDER_FRAMES = 3;
+    const int PRI_TICKS = 1000;   // 元数据时间戳间隔
+    bool tlast_err = false;
+    bool hdr_err = false;
+    bool order_err = false;
+    vector<my_complex_t> base_cells;   // 第 0 帧 (距离优先、自然顺序) 作为参考
+    pc_fir_tap_t no_taps[PC_FIR_MAX_TAPS];   // pc_fir_taps = 0，抽头口不读
+    dop_win_t dop_win[N_PULSE];        // 本 TB 不加窗 (win_en = 0)
+    for (int p = 0; p < N_PULSE; p++) dop_win[p] = 1;
+
+    for (int frame = 0; frame < NUM_FRAMES + NUM_ORDER_FRAMES; frame++) {
+        int mode = (frame < NUM_FRAMES) ? 0 : frame - NUM_FRAMES + 1;
+        radar_ctrl_t ctrl;
+        ctrl.dop_major = mode & 1;
+        ctrl.dop_shift = (mode >> 1) & 1;
+        ctrl.n_pulse = N_PULSE;
+        ctrl.win_en = 0;
+        ctrl.presum_log2 = 0;
+        ctrl.presum_fcw = 0;
+        ctrl.dop_first = 0;
+        ctrl.dop_bins = 0;
+        ctrl.pc_fir_taps = 0;
+        ctrl.tlast_pulse = 0;
+#ifdef CT_COMPRESS
+        ctrl.dop_major = 0;   // 压缩存储只支持距离优先
+#endif
 
-    for (int frame = 0; frame < NUM_FRAMES; frame++) {
         cout << "---------------------------------------------" << endl;
-        cout << ">> [TB] Processing Frame " << frame << " / " << NUM_FRAMES - 1 << "..." << endl;
+        cout << ">> [TB] Processing Frame " << frame << " / " << NUM_FRAMES + NUM_ORDER_FRAMES - 1
+             << " (order: " << (ctrl.dop_major ? "doppler-major" : "range-major")
+             << (ctrl.dop_shift ? ", fftshift" : "") << ")..." << endl;
 
         // --- Step A: 注入一帧数据 ---
         for (int i = 0; i < samples_per_frame; i++) {
             // 从 buffer 获取数据 (如果不够就补0)
-            int r = (i < data_buffer.size()) ? data_buffer[i].re : 0;
-            int i_val = (i < data_buffer.size()) ? data_buffer[i].im : 0;
+            int r = ((size_t)i < data_buffer.size()) ? data_buffer[i].re : 0;
+            int i_val = ((size_t)i < data_buffer.size()) ? data_buffer[i].im : 0;
 
             axis_in_t pkt;
             pkt.data = 0;
@@ -90,43 +119,114 @@ int main() {
             pkt.keep = -1;
             pkt.strb = -1;
 
+            // TUSER: 每个脉冲第一个样点携带元数据
+            pkt.user = 0;
+            if (i % N_RANGE == 0) {
+                pulse_meta_t meta;
+                meta.pulse_idx = frame * N_PULSE + i / N_RANGE;
+                meta.timestamp = (frame * N_PULSE + i / N_RANGE) * PRI_TICKS;
+                meta.waveform = 1;
+                meta.channel = 0;
+                pkt.user = pulse_meta_pack(meta);
+            }
+
             input_stream.write(pkt);
         }
 
         // --- Step B: 调用 DUT ---
         // 注意：debug 计数器会累加，方便观察总进度
-        radar_top(input_stream, output_stream, &debug_in_cnt, &debug_out_cnt);
+        radar_top(input_stream, output_stream, ctrl, dop_win, no_taps, &debug_in_cnt, &debug_out_cnt);
 
         // --- Step C: 读取并保存输出 ---
         int frame_out_cnt = 0;
         double max_mag = 0.0;
         int max_idx = -1;
 
+        int frame_beats = 0;
+        int last_cnt = 0;
+        bool last_ok = true;
+
+        // 帧头：逐字解包后核对
+        vector<ap_uint<32> > hdr;
+        for (int b = 0; b < FRAME_HDR_BEATS && !output_stream.empty(); b++) {
+            axis_rd_t hdr_pkt = output_stream.read();
+            if (hdr_pkt.last) last_ok = false;
+            for (int k = 0; k < OUT_CELLS_PER_BEAT; k++) hdr.push_back(rd_beat_word(hdr_pkt, k));
+        }
+        bool hdr_ok = hdr.size() == FRAME_HDR_WORDS && hdr[0] == FRAME_HDR_MAGIC
+                   && hdr[2] == (unsigned)frame
+                   && hdr[4] == (unsigned)(frame * N_PULSE * PRI_TICKS)
+                   && hdr[5] == (unsigned)((frame * N_PULSE + N_PULSE - 1) * PRI_TICKS)
+                   && hdr[7] == (unsigned)(((int)ctrl.dop_major << 8) | ((int)ctrl.dop_shift << 9) | (N_PULSE << 16));
+        for (int p = 0; hdr_ok && p < N_PULSE; p++) {
+            if (hdr[FRAME_HDR_FIXED + 2 * p + 1].range(15, 0) != (unsigned)(frame * N_PULSE + p)) hdr_ok = false;
+        }
+        if (!hdr_ok) {
+            cout << "   - ERROR: Frame header mismatch!" << endl;
+            hdr_err = true;
+        } else {
+            cout << "   - Frame Header: #" << hdr[2] << ", t = " << hdr[4] << " .. " << hdr[5] << endl;
+        }
+
+        vector<my_complex_t> cells;
         while (!output_stream.empty()) {
-            axis_out_t out_pkt = output_stream.read();
-
-            // 写入文件
-            double re = out_pkt.data.re.to_double();
-            double im = out_pkt.data.im.to_double();
-            file_out << re << " " << im << endl;
-
-            // 简单的帧内统计
-            double mag = sqrt(re*re + im*im);
-            if (mag > max_mag) {
-                max_mag = mag;
-                max_idx = frame_out_cnt;
+            axis_rd_t out_pkt = output_stream.read();
+            frame_beats++;
+            if (out_pkt.last) {
+                last_cnt++;
+                if (!output_stream.empty()) last_ok = false; // TLAST 只能出现在帧尾
+            }
+
+            // 按 keep 解包 beat 内的每个单元
+            for (int k = 0; k < rd_beat_cells(out_pkt); k++) {
+                my_complex_t cell = rd_beat_cell(out_pkt, k);
+                cells.push_back(cell);
+
+                // 写入文件 (只写默认顺序的帧)
+                double re = cell.re.to_double();
+                double im = cell.im.to_double();
+                if (mode == 0) file_out << re << " " << im << endl;
+
+                // 简单的帧内统计
+                double mag = sqrt(re*re + im*im);
+                if (mag > max_mag) {
+                    max_mag = mag;
+                    max_idx = frame_out_cnt;
+                }
+                frame_out_cnt++;
+            }
+        }
+        if (last_cnt != 1 || !last_ok) {
+            cout << "   - ERROR: TLAST count " << last_cnt << " (expected 1 at frame end)" << endl;
+            tlast_err = true;
+        }
+
+        // 输出顺序：第 i 个单元对应的 (距离, 自然多普勒 bin)，与第 0 帧逐点比较
+        if (frame == 0) base_cells = cells;
+        if (mode != 0) {
+            bool same = cells.size() == base_cells.size();
+            for (int i = 0; same && i < (int)cells.size(); i++) {
+                int r = ctrl.dop_major ? i % N_RANGE : i / N_PULSE;
+                int d = ctrl.dop_major ? i / N_RANGE : i % N_PULSE;
+                if (ctrl.dop_shift) d ^= N_PULSE / 2;
+                const my_complex_t &ref = base_cells[r * N_PULSE + d];
+                if (cells[i].re != ref.re || cells[i].im != ref.im) same = false;
+            }
+            if (!same) {
+                cout << "   - ERROR: Output ordering mismatch!" << endl;
+                order_err = true;
             }
-            frame_out_cnt++;
         }
 
         // --- Step D: 打印当前帧状态 ---
         cout << "   - Frame Finished." << endl;
-        cout << "   - Output Samples: " << frame_out_cnt << endl;
+        cout << "   - Output Samples: " << frame_out_cnt
+             << " (" << frame_beats << " beats x " << OUT_CELLS_PER_BEAT << " cells)" << endl;
         cout << "   - Debug Counters (Cumulative): In=" << debug_in_cnt << ", Out=" << debug_out_cnt << endl;
 
         if (max_idx >= 0) {
-            int peak_range = max_idx / N_PULSE;
-            int peak_doppler = max_idx % N_PULSE;
+            int peak_range = ctrl.dop_major ? max_idx % N_RANGE : max_idx / N_PULSE;
+            int peak_doppler = ctrl.dop_major ? max_idx / N_RANGE : max_idx % N_PULSE;
             cout << "   - Frame Peak -> Mag: " << max_mag
                  << " @ Range: " << peak_range << ", Doppler: " << peak_doppler << endl;
         } else {
@@ -141,8 +241,23 @@ int main() {
     // ------------------------------------------------------
     cout << "---------------------------------------------" << endl;
     cout << ">> [TB] All frames processed." << endl;
+#ifdef RADAR_FFT_XCHECK
+    {
+        radar_fft_xcheck_t &xs = radar_fft_xcheck_stats();
+        cout << ">> [TB] FFT cross-check: " << xs.frames << " frames, max error " << xs.max_lsb
+             << " LSB, " << xs.bad_frames << " over tolerance, " << xs.ovflo_diff
+             << " ovflo mismatches" << endl;
+        if (xs.bad_frames || xs.ovflo_diff) {
+            cout << ">> [FAIL] Native FFT model disagrees with hls::fft!" << endl;
+            return 1;
+        }
+    }
+#endif
 
-    if (debug_out_cnt > 0) {
+    if (tlast_err || hdr_err || order_err) {
+        cout << ">> [FAIL] Output framing (TLAST / header / ordering) error!" << endl;
+        return 1;
+    } else if (debug_out_cnt > 0) {
         cout << ">> [PASS] Testbench finished successfully." << endl;
     } else {
         cout << ">> [FAIL] No data output detected across all frames!" << endl;
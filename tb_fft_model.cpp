@@ -0,0 +1,159 @@
+#define RADAR_FFT_XCHECK
+#include "radar_defines.h"
+#include "radar_fft.h"
+
+#ifdef RADAR_FLOAT_DATAPATH
+#error "tb_fft_model checks the fixed-point FFT model; build without RADAR_FLOAT_DATAPATH"
+#endif
+#include <iostream>
+#include <vector>
+#include <complex>
+#include <cmath>
+#include <cstdlib>
+#include <chrono>
+
+using namespace std;
+
+// =========================================================
+// C-sim FFT 模型交叉校验 Testbench (radar_fft.h，本文件强制 RADAR_FFT_XCHECK)
+// 1. 对三种 FFT 配置 (脉压 / 多普勒 / 频率估计)，正反变换、多种缩放调度与输入幅度，
+//    送随机帧经 radar_fft，由交叉校验逐点比较原生模型与 hls::fft
+//    要求最大误差 <= RADAR_FFT_XCHECK_TOL LSB，且不溢出的用例 ovflo 一致
+// 2. sch = 0 + 满幅输入必然溢出，两种实现都应报 ovflo
+// 3. 分别计时 hls::fft 与原生模型，给出加速比
+// =========================================================
+
+const int FRAMES = 16;
+
+static void fill_frame(hls::stream<complex_t> &s, int n, double amp) {
+    for (int i = 0; i < n; i++) {
+        double re = amp * (2.0 * rand() / RAND_MAX - 1.0);
+        double im = amp * (2.0 * rand() / RAND_MAX - 1.0);
+        s.write(complex_t(fft_data_t(re), fft_data_t(im)));
+    }
+}
+
+// 跑 FRAMES 帧，返回 hls::fft 报 ovflo 的帧数
+template <class CFG>
+static int run_case(bool fwd, unsigned sch, double amp) {
+    const int n = 1 << CFG::max_nfft;
+    hls::stream<complex_t> in, out;
+    hls::stream<hls::ip_fft::config_t<CFG> > cfg_s;
+    hls::stream<hls::ip_fft::status_t<CFG> > sts_s;
+    int ovf = 0;
+    for (int f = 0; f < FRAMES; f++) {
+        hls::ip_fft::config_t<CFG> cfg;
+        cfg.setDir(fwd);
+        cfg.setSch(sch);
+        cfg_s.write(cfg);
+        fill_frame(in, n, amp);
+        radar_fft<CFG>(in, out, sts_s, cfg_s);
+        for (int i = 0; i < n; i++) out.read();
+        ovf += sts_s.read().getOvflo() != 0;
+    }
+    return ovf;
+}
+
+template <class CFG>
+static bool check_config(const char *name) {
+    radar_fft_xcheck_t &xs = radar_fft_xcheck_stats();
+    const int log2n = CFG::max_nfft;
+    const unsigned full = fft_full_sch(log2n);
+    bool ok = true;
+
+    long bad0 = xs.bad_frames, ovd0 = xs.ovflo_diff;
+    xs.max_lsb = 0;
+    for (int dir = 0; dir < 2; dir++) {
+        run_case<CFG>(dir != 0, full, 0.99);
+        run_case<CFG>(dir != 0, full, 0.01);
+    }
+    int max_lsb = xs.max_lsb;
+    long bad = xs.bad_frames - bad0, ovd = xs.ovflo_diff - ovd0;
+    cout << "   - " << name << " (" << (1 << log2n) << " pt, sch 0x" << hex << full << dec
+         << "): max error " << max_lsb << " LSB, " << bad << " frames over tolerance, "
+         << ovd << " ovflo mismatches" << endl;
+    if (bad || ovd) ok = false;
+
+    // 不缩放 + 满幅：必然溢出
+    ovd0 = xs.ovflo_diff;
+    int ovf = run_case<CFG>(true, 0, 0.99);
+    if (ovf != FRAMES || xs.ovflo_diff != ovd0) {
+        cout << ">> [FAIL] " << name << ": sch 0 overflow flagged " << ovf << "/" << FRAMES
+             << " frames, " << (xs.ovflo_diff - ovd0) << " mismatches" << endl;
+        ok = false;
+    }
+    return ok;
+}
+
+// 单独计时：hls::fft 与原生模型各跑 reps 帧
+template <class CFG>
+static void time_config(const char *name, int reps) {
+    const int n = 1 << CFG::max_nfft;
+    const unsigned sch = fft_full_sch(CFG::max_nfft);
+    vector<complex_t> x(n);
+    for (int i = 0; i < n; i++) {
+        x[i] = complex_t(fft_data_t(0.5 * rand() / RAND_MAX), fft_data_t(0.5 * rand() / RAND_MAX));
+    }
+
+    auto t0 = chrono::steady_clock::now();
+    for (int k = 0; k < reps; k++) {
+        hls::stream<complex_t> in, out;
+        hls::stream<hls::ip_fft::config_t<CFG> > cfg_s;
+        hls::stream<hls::ip_fft::status_t<CFG> > sts_s;
+        hls::ip_fft::config_t<CFG> cfg;
+        cfg.setDir(1);
+        cfg.setSch(sch);
+        cfg_s.write(cfg);
+        for (int i = 0; i < n; i++) in.write(x[i]);
+        hls::fft<CFG>(in, out, sts_s, cfg_s);
+        for (int i = 0; i < n; i++) out.read();
+        sts_s.read();
+    }
+    auto t1 = chrono::steady_clock::now();
+    // 与 RADAR_FAST_FFT 下 radar_fft() 的路径相同：读流、按位转整数、原生 FFT、转回、写流
+    vector<int64_t> re(n), im(n);
+    for (int k = 0; k < reps; k++) {
+        hls::stream<complex_t> in, out;
+        for (int i = 0; i < n; i++) in.write(x[i]);
+        for (int i = 0; i < n; i++) {
+            complex_t v = in.read();
+            re[i] = radar_fft_to_raw<CFG::input_width>(v.real());
+            im[i] = radar_fft_to_raw<CFG::input_width>(v.imag());
+        }
+        radar_fft_native<CFG>(re.data(), im.data(), CFG::max_nfft, true, sch);
+        for (int i = 0; i < n; i++) {
+            out.write(complex_t(radar_fft_from_raw<CFG::output_width, fft_data_t>(re[i]),
+                                radar_fft_from_raw<CFG::output_width, fft_data_t>(im[i])));
+        }
+        for (int i = 0; i < n; i++) out.read();
+    }
+    auto t2 = chrono::steady_clock::now();
+    double us_ref = chrono::duration<double, micro>(t1 - t0).count() / reps;
+    double us_fast = chrono::duration<double, micro>(t2 - t1).count() / reps;
+    cout << "   - " << name << ": hls::fft " << us_ref << " us/frame, native " << us_fast
+         << " us/frame (x" << us_ref / us_fast << ")" << endl;
+}
+
+int main() {
+    cout << ">> [TB] Cross-checking native C-sim FFT against hls::fft (tol "
+         << RADAR_FFT_XCHECK_TOL << " LSB)..." << endl;
+    srand(1);
+
+    bool ok = true;
+    ok &= check_config<fft_config>("range");
+    ok &= check_config<doppler_fft_config>("doppler");
+    ok &= check_config<doppler_est_fft_config>("dop_est");
+
+    cout << ">> [TB] Timing" << endl;
+    time_config<fft_config>("range", 2000);
+    time_config<doppler_est_fft_config>("dop_est", 200);
+
+    radar_fft_xcheck_t &xs = radar_fft_xcheck_stats();
+    cout << ">> [TB] " << xs.frames << " frames checked" << endl;
+    if (!ok) {
+        cout << ">> [FAIL] Native FFT model disagrees with hls::fft." << endl;
+        return 1;
+    }
+    cout << ">> [PASS] Native FFT model matches hls::fft within tolerance." << endl;
+    return 0;
+}
@@ -0,0 +1,268 @@
+#include "radar_defines.h"
+#include "radar_precision.h"
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <type_traits>
+
+using namespace std;
+
+// =========================================================
+// 定点位宽扫描 Testbench
+// 对每组 (adc_t, fft_data_t, coeff_t) 位宽运行整条处理链，并与双精度参考比较：
+//   - 输出 SNR   : sum|ref|^2 / sum|dut - ref|^2 (整张 RD 图)
+//   - PSL        : 峰值所在多普勒通道的距离剖面，峰值旁瓣比 (主瓣 +-2 门以外)
+//   - 溢出计数   : FFT status 溢出、匹配滤波乘法回绕、输入饱和
+// 多普勒缩放调度同时扫描 DOP_FFT_SCH 与全缩放两种 (积累增益可能让前者溢出)
+// 最后给出满足 SNR 预算的最窄组合 (按每个 RD 单元存储位宽 2*DATA_W 排序)
+// 另外在当前位宽下扫描角转换块浮点尾数位宽 (CT_COMPRESS)，给出存储节省与 SNR 代价
+// 扫描之前先检查模型本身：当前位宽的实例必须与 radar_top 的处理级逐位相同，
+// 否则 radar_top.cpp 改动后模型已不代表实际数据通路，扫描结果无效 (FAIL)
+// =========================================================
+
+const double SNR_BUDGET_DB = 40.0;
+
+struct sweep_result_t {
+    string name;
+    int adc_w, data_w, coeff_w;
+    unsigned dop_sch;
+    double snr_db;
+    double psl_db;
+    prec_stats_t st;
+};
+
+static double calc_snr_db(const vector<complex<double> > &ref, const vector<complex<double> > &dut) {
+    double ps = 0.0, pn = 0.0;
+    for (size_t i = 0; i < ref.size(); i++) {
+        ps += norm(ref[i]);
+        pn += norm(dut[i] - ref[i]);
+    }
+    return 10.0 * log10(ps / (pn + 1e-30));
+}
+
+static double calc_psl_db(const vector<complex<double> > &rd) {
+    size_t pk = 0;
+    for (size_t i = 0; i < rd.size(); i++) {
+        if (abs(rd[i]) > abs(rd[pk])) pk = i;
+    }
+    int pr = (int)pk / N_PULSE, pd = (int)pk % N_PULSE;
+    double side = 0.0;
+    for (int r = 0; r < N_RANGE; r++) {
+        int dist = abs(r - pr);
+        dist = min(dist, N_RANGE - dist);
+        if (dist <= 2) continue;
+        side = max(side, abs(rd[r * N_PULSE + pd]));
+    }
+    return 20.0 * log10(side / abs(rd[pk]) + 1e-30);
+}
+
+// 模型 (14/16/16，不压缩或 CT_COMPRESS 的尾数位宽) 与 radar_top 处理级的输出逐位比较
+// 直接调用 radar_top_t，不经软件后端；浮点数据通路下没有可比的定点输出，跳过
+static bool check_model_vs_top(const vector<uint32_t> &words) {
+#ifdef RADAR_FLOAT_DATAPATH
+    (void)words;
+    cout << ">> [TB] Model check skipped (RADAR_FLOAT_DATAPATH has no fixed-point radar_top to match)." << endl;
+    return true;
+#else
+    typedef radar_prec_model<14, 16, 16> model_t;
+    static_assert(std::is_same<adc_t, model_t::p_adc_t>::value && std::is_same<fft_data_t, model_t::p_data_t>::value &&
+                  std::is_same<dp_data_t, model_t::p_coeff_t>::value,
+                  "update the model check to the radar_defines.h datapath types");
+    stream_in_t in;
+    for (int i = 0; i < N_PULSE * N_RANGE; i++) {
+        axis_in_t pkt;
+        pkt.data = words[i];
+        pkt.last = (i == N_PULSE * N_RANGE - 1);
+        pkt.keep = -1;
+        pkt.strb = -1;
+        pkt.user = 0;
+        in.write(pkt);
+    }
+    radar_ctrl_t ctrl;
+    ctrl.dop_major = 0;
+    ctrl.dop_shift = 0;
+    ctrl.n_pulse = N_PULSE;
+    ctrl.win_en = 0;
+    ctrl.presum_log2 = 0;
+    ctrl.presum_fcw = 0;
+    ctrl.dop_first = 0;
+    ctrl.dop_bins = 0;
+    ctrl.pc_fir_taps = 0;
+    ctrl.tlast_pulse = 0;
+    cfar_ctrl_t cfar_ctrl;
+    cfar_ctrl.scale = 0;
+    tap_ctrl_t tap_ctrl;
+    tap_ctrl.mode = 0;
+    tap_ctrl.decim_log2 = 0;
+    pc_fir_tap_t no_taps[PC_FIR_MAX_TAPS];   // pc_fir_taps = 0，抽头口不读
+    dop_win_t dop_win[N_PULSE];
+    for (int p = 0; p < N_PULSE; p++) dop_win[p] = 1;
+    stream_rd_t out, no_tap;
+    stream_meta_t no_meta;
+    stream_det_t no_det;
+    ap_uint<32> d_in, d_out;
+    radar_top_t<radar_stages_pc_dop>(in, out, no_meta, no_det, no_tap, ctrl, cfar_ctrl, tap_ctrl, dop_win,
+                                     no_taps, &d_in, &d_out);
+
+    vector<uint32_t> top;
+    while (!out.empty()) {
+        axis_rd_t beat = out.read();
+        for (int k = 0; k < rd_beat_cells(beat); k++) top.push_back(rd_beat_word(beat, k).to_uint());
+    }
+
+#ifdef CT_COMPRESS
+    const int ct_mant = CT_MANT_BITS;
+#else
+    const int ct_mant = 0;
+#endif
+    vector<complex<double> > model(N_RANGE * N_PULSE);
+    prec_stats_t st;
+    model_t::run_frame(words.data(), model.data(), st, DOP_FFT_SCH, ct_mant);
+
+    int n_diff = (int)top.size() == FRAME_HDR_WORDS + N_RANGE * N_PULSE ? 0 : -1;
+    for (int i = 0; n_diff >= 0 && i < N_RANGE * N_PULSE; i++) {
+        const uint32_t w = top[FRAME_HDR_WORDS + i];
+        const int16_t re = (int16_t)(w & 0xFFFF), im = (int16_t)(w >> 16);
+        if (re != lround(model[i].real() * 32768.0) || im != lround(model[i].imag() * 32768.0)) n_diff++;
+    }
+    if (n_diff != 0) {
+        cout << ">> [TB] Model check: " << (n_diff < 0 ? "radar_top output size mismatch" : to_string(n_diff) +
+                " RD cells differ from radar_top") << endl;
+        return false;
+    }
+    cout << ">> [TB] Model check: adc14/data16/coef16" << (ct_mant ? " + CT_COMPRESS" : "")
+         << " is bit-identical to radar_top." << endl;
+    return true;
+#endif
+}
+
+template <int A, int D, int C>
+static sweep_result_t run_case(const vector<uint32_t> &words, const vector<complex<double> > &ref,
+                               unsigned dop_sch) {
+    sweep_result_t res;
+    res.adc_w = A;
+    res.data_w = D;
+    res.coeff_w = C;
+    res.dop_sch = dop_sch;
+    res.name = "adc" + to_string(A) + "/data" + to_string(D) + "/coef" + to_string(C);
+    vector<complex<double> > out(N_RANGE * N_PULSE);
+    radar_prec_model<A, D, C>::run_frame(words.data(), out.data(), res.st, dop_sch);
+    res.snr_db = calc_snr_db(ref, out);
+    res.psl_db = calc_psl_db(out);
+    return res;
+}
+
+int main() {
+    ifstream file_in("input_stimulus.dat");
+    if (!file_in.is_open()) {
+        cout << "ERROR: Cannot open input_stimulus.dat!" << endl;
+        return 1;
+    }
+    vector<uint32_t> words(N_PULSE * N_RANGE, 0);
+    int re_in, im_in, n = 0;
+    while (n < N_PULSE * N_RANGE && file_in >> re_in >> im_in) {
+        ap_uint<32> w = 0;
+        ap_int<14> r_14 = re_in;
+        ap_int<14> i_14 = im_in;
+        w.range(13, 0) = r_14;
+        w.range(29, 16) = i_14;
+        words[n++] = w.to_uint();
+    }
+
+    if (!check_model_vs_top(words)) {
+        cout << ">> [FAIL] Precision model no longer matches radar_top; update radar_precision.h." << endl;
+        return 1;
+    }
+
+    const unsigned sch_list[2] = { DOP_FFT_SCH, fft_full_sch(doppler_fft_config::max_nfft) };
+    vector<sweep_result_t> results;
+
+    for (int s = 0; s < 2; s++) {
+        unsigned sch = sch_list[s];
+        cout << ">> [TB] Building double-precision reference (Doppler sch=0x" << hex << sch << dec << ")..." << endl;
+        vector<complex<double> > ref(N_RANGE * N_PULSE);
+        prec_reference_frame(words.data(), ref.data(), sch);
+        cout << ">> [TB] Reference PSL: " << calc_psl_db(ref) << " dB" << endl;
+
+        // 扫描列表：第一项为 radar_defines.h 当前配置
+        results.push_back(run_case<14, 16, 16>(words, ref, sch));
+        results.push_back(run_case<14, 18, 16>(words, ref, sch));
+        results.push_back(run_case<14, 20, 18>(words, ref, sch));
+        results.push_back(run_case<14, 16, 12>(words, ref, sch));
+        results.push_back(run_case<14, 14, 14>(words, ref, sch));
+        results.push_back(run_case<12, 14, 12>(words, ref, sch));
+        results.push_back(run_case<12, 12, 12>(words, ref, sch));
+        results.push_back(run_case<10, 12, 10>(words, ref, sch));
+        results.push_back(run_case<10, 10, 10>(words, ref, sch));
+        results.push_back(run_case< 8, 10,  8>(words, ref, sch));
+    }
+
+    cout << left << setw(24) << "types" << right << setw(8) << "dopSch" << setw(10) << "SNR(dB)" << setw(10) << "PSL(dB)"
+         << setw(9) << "fftOvf" << setw(9) << "ifftOvf" << setw(9) << "dopOvf"
+         << setw(9) << "mulOvf" << setw(9) << "adcSat" << endl;
+    for (size_t i = 0; i < results.size(); i++) {
+        const sweep_result_t &r = results[i];
+        cout << left << setw(24) << r.name << right << setw(6) << "0x" << hex << setw(2) << r.dop_sch << dec
+             << fixed << setprecision(2)
+             << setw(10) << r.snr_db << setw(10) << r.psl_db
+             << setw(9) << r.st.fft_ovf << setw(9) << r.st.ifft_ovf << setw(9) << r.st.dop_ovf
+             << setw(9) << r.st.mult_ovf << setw(9) << r.st.adc_sat << endl;
+    }
+    if (results[0].st.dop_ovf > 0) {
+        cout << ">> [TB] WARNING: current DOP_FFT_SCH overflows on this stimulus." << endl;
+    }
+
+    // 最窄满足预算的组合 (优先角转换存储位宽，其次系数与 ADC 位宽)
+    int best = -1;
+    for (size_t i = 0; i < results.size(); i++) {
+        const sweep_result_t &r = results[i];
+        bool ok = r.snr_db >= SNR_BUDGET_DB && r.st.fft_ovf + r.st.ifft_ovf + r.st.dop_ovf + r.st.mult_ovf == 0;
+        if (!ok) continue;
+        if (best < 0) { best = (int)i; continue; }
+        const sweep_result_t &b = results[best];
+        int cost_r = r.data_w * 1000 + r.coeff_w * 10 + r.adc_w;
+        int cost_b = b.data_w * 1000 + b.coeff_w * 10 + b.adc_w;
+        if (cost_r < cost_b) best = (int)i;
+    }
+
+    // 角转换压缩：当前位宽 + 全缩放多普勒调度 (避免溢出掩盖量化误差)
+    {
+        unsigned sch = sch_list[1];
+        vector<complex<double> > ref(N_RANGE * N_PULSE), base(N_RANGE * N_PULSE), out(N_RANGE * N_PULSE);
+        prec_reference_frame(words.data(), ref.data(), sch);
+        prec_stats_t st0;
+        radar_prec_model<14, 16, 16>::run_frame(words.data(), base.data(), st0, sch);
+        double snr0 = calc_snr_db(ref, base);
+
+        cout << "---------------------------------------------" << endl;
+        cout << ">> [TB] Corner-turn BFP (adc14/data16/coef16, Doppler sch=0x" << hex << sch << dec << ")" << endl;
+        cout << left << setw(10) << "mant" << right << setw(6) << "pack" << setw(10) << "bits/row"
+             << setw(10) << "saving" << setw(10) << "SNR(dB)" << setw(10) << "cost(dB)" << setw(14) << "vsUncomp(dB)"
+             << endl;
+        for (int m = 12; m >= 8; m--) {
+            prec_stats_t st;
+            radar_prec_model<14, 16, 16>::run_frame(words.data(), out.data(), st, sch, m);
+            double snr = calc_snr_db(ref, out);
+            // 按 72 位 BRAM 字装满 (CT_PACK)，每行 ceil(N_RANGE / pack) 个字加 4 位共享指数，对比 32 位 complex_t
+            const int pack = 72 / (2 * m);
+            const int row_bits = (N_RANGE + pack - 1) / pack * 2 * m * pack + 4;
+            cout << left << setw(10) << m << right << setw(6) << pack << setw(10) << row_bits << fixed
+                 << setprecision(1) << setw(9) << 100.0 * (1.0 - row_bits / (32.0 * N_RANGE)) << "%" << setprecision(2)
+                 << setw(10) << snr << setw(10) << snr0 - snr
+                 << setw(14) << calc_snr_db(base, out) << endl;
+        }
+    }
+
+    cout << "---------------------------------------------" << endl;
+    if (best < 0) {
+        cout << ">> [FAIL] No combination meets the " << SNR_BUDGET_DB << " dB SNR budget." << endl;
+        return 1;
+    }
+    cout << ">> [TB] Narrowest combination meeting " << SNR_BUDGET_DB << " dB: " << results[best].name
+         << " (Doppler sch=0x" << hex << results[best].dop_sch << dec << ")" << endl;
+    cout << ">> [PASS] Precision sweep finished." << endl;
+    return 0;
+}
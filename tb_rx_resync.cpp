@@ -0,0 +1,279 @@
+#include "radar_defines.h"
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+
+using namespace std;
+
+// =========================================================
+// 输入帧同步 (TLAST 重同步) Testbench
+// 同一组 CPI 分别以无错与注入丢样点 / 多样点的形式送入，比较输出：
+// 1. radar_top，整次调用一个 TLAST：出错 CPI 的帧头标志与字 9 正确，之后的 CPI 与无错时逐位相同
+// 2. radar_top_pc，逐脉冲 TLAST：只有出错脉冲的距离像改变，元数据 rx_err 标出该脉冲，下一个 CPI 不受影响
+// 3. radar_top，预积累 K=2 + 逐脉冲 TLAST：字 9 按行计数
+// 4. radar_top_pc，逐脉冲 TLAST：首个脉冲就是长包、短包之后紧跟长包，都只影响出错的脉冲
+//    (TLAST 约定由 ctrl.tlast_pulse 给出，不依赖之前的脉冲是否恰好在 TLAST 处结束)
+// 每次调用后输入流应恰好读空 (多余样点被读掉，不留给下一次调用)
+// =========================================================
+
+const int TS_STEP = 100;
+
+static radar_ctrl_t make_ctrl(int n_pulse, int presum_log2, bool per_pulse) {
+    radar_ctrl_t ctrl;
+    ctrl.dop_major = 0;
+    ctrl.dop_shift = 1;
+    ctrl.n_pulse = n_pulse;
+    ctrl.win_en = 0;
+    ctrl.presum_log2 = presum_log2;
+    ctrl.presum_fcw = 0;
+    ctrl.dop_first = 0;
+    ctrl.dop_bins = 0;
+    ctrl.pc_fir_taps = 0;
+    ctrl.tlast_pulse = per_pulse;
+    return ctrl;
+}
+
+// 一个 CPI 的输入 beat：n_in 个脉冲，随机样点 (14 位内)，per_pulse 时每个脉冲末尾一个 TLAST，否则只在最后一个样点
+static vector<axis_in_t> make_cpi(int n_in, int cpi, bool per_pulse) {
+    srand(1234 + cpi);
+    vector<axis_in_t> beats;
+    for (int m = 0; m < n_in; m++) {
+        pulse_meta_t meta;
+        meta.timestamp = (cpi * n_in + m) * TS_STEP;
+        meta.pulse_idx = cpi * n_in + m;
+        meta.waveform = 1;
+        meta.channel = 0;
+        for (int i = 0; i < N_RANGE; i++) {
+            axis_in_t pkt;
+            pkt.data = 0;
+            pkt.data.range(13, 0) = (rand() % 4001) - 2000;
+            pkt.data.range(29, 16) = (rand() % 4001) - 2000;
+            pkt.last = per_pulse ? (i == N_RANGE - 1) : (m == n_in - 1 && i == N_RANGE - 1);
+            pkt.keep = -1;
+            pkt.strb = -1;
+            pkt.user = (i == 0) ? pulse_meta_pack(meta) : ap_uint<PULSE_META_W>(0);
+            beats.push_back(pkt);
+        }
+    }
+    return beats;
+}
+
+// 第 m 个脉冲第 i 个样点处丢掉 n 个样点 (n < 0) 或插入 n 个额外样点 (n > 0)
+static void inject(vector<axis_in_t> &beats, int m, int i, int n) {
+    const int pos = m * N_RANGE + i;
+    if (n < 0) {
+        beats.erase(beats.begin() + pos, beats.begin() + pos - n);
+        return;
+    }
+    axis_in_t extra = beats[pos];
+    extra.last = 0;
+    extra.user = 0;
+    beats.insert(beats.begin() + pos, n, extra);
+}
+
+static void push(stream_in_t &in, const vector<axis_in_t> &beats) {
+    for (size_t k = 0; k < beats.size(); k++) in.write(beats[k]);
+}
+
+// 一次 radar_top 调用，输出展开为 32 位字 (帧头 + RD 单元)
+static vector<uint32_t> run_top(const vector<axis_in_t> &beats, radar_ctrl_t ctrl, bool &drained) {
+    stream_in_t in;
+    stream_rd_t out;
+    push(in, beats);
+    pc_fir_tap_t no_taps[PC_FIR_MAX_TAPS];   // pc_fir_taps = 0，抽头口不读
+    dop_win_t dop_win[N_PULSE];
+    for (int p = 0; p < N_PULSE; p++) dop_win[p] = 1;
+    ap_uint<32> d_in, d_out;
+    radar_top(in, out, ctrl, dop_win, no_taps, &d_in, &d_out);
+    drained = in.empty();
+
+    vector<uint32_t> words;
+    while (!out.empty()) {
+        axis_rd_t beat = out.read();
+        for (int k = 0; k < rd_beat_cells(beat); k++) words.push_back(rd_beat_word(beat, k).to_uint());
+    }
+    return words;
+}
+
+// 与参考帧比较 (跳过帧计数字 2)，并检查帧头标志 bit2/bit3 与字 9
+static bool check_frame(const char *name, const vector<uint32_t> &got, const vector<uint32_t> &ref,
+                        bool drained, uint32_t want_rx_err, bool want_same) {
+    bool ok = drained && got.size() == ref.size() && (int)got.size() > FRAME_HDR_WORDS;
+    int n_diff = 0;
+    for (size_t k = 0; ok && k < got.size(); k++) {
+        if (k != 2 && got[k] != ref[k]) n_diff++;
+    }
+    if (!ok) {
+        cout << "   - " << name << ": " << got.size() << " words (want " << ref.size() << ")"
+             << (drained ? "" : ", input not drained") << endl;
+        return false;
+    }
+    const uint32_t flags = got[7];
+    const uint32_t rx_err = got[9];
+    const bool flags_ok = ((flags >> 2) & 1) == ((want_rx_err & 0xFFFF) != 0) &&
+                          ((flags >> 3) & 1) == ((want_rx_err >> 16) != 0);
+    ok = flags_ok && rx_err == want_rx_err && (!want_same || n_diff == 0);
+    cout << "   - " << name << ": rx_err word 0x" << hex << rx_err << dec << ", flags bit2/3 "
+         << ((flags >> 2) & 1) << "/" << ((flags >> 3) & 1) << ", " << n_diff << " words differ from clean run"
+         << (ok ? "" : "  <-- FAIL") << endl;
+    return ok;
+}
+
+// 1. 整次调用一个 TLAST：CPI 0 丢一个样点 (末脉冲短包)，CPI 2 多两个样点 (末脉冲长包)
+static bool test_call_tlast() {
+    cout << "[1] radar_top, one TLAST per call" << endl;
+    radar_ctrl_t ctrl = make_ctrl(N_PULSE, 0, false);
+    vector<vector<uint32_t> > ref(4);
+    bool drained = true, ok = true;
+    for (int c = 0; c < 4; c++) ref[c] = run_top(make_cpi(N_PULSE, c, false), ctrl, drained);
+    for (int c = 0; c < 4; c++) {
+        vector<axis_in_t> beats = make_cpi(N_PULSE, c, false);
+        if (c == 0) inject(beats, 40, 17, -1);
+        if (c == 2) inject(beats, 90, 3, 2);
+        vector<uint32_t> got = run_top(beats, ctrl, drained);
+        const char *names[4] = { "CPI 0 (1 sample dropped)", "CPI 1", "CPI 2 (2 extra samples)", "CPI 3" };
+        const uint32_t want[4] = { 0x1, 0, 0x10000, 0 };
+        ok &= check_frame(names[c], got, ref[c], drained, want[c], c == 1 || c == 3);
+    }
+    return ok;
+}
+
+// 一次 radar_top_pc 调用：距离像单元与逐脉冲元数据，返回输入是否读空
+static bool run_pc(const vector<axis_in_t> &beats, int n_pulse, vector<uint32_t> &words,
+                   vector<pulse_meta_t> &metas) {
+    stream_in_t in;
+    stream_rd_t out;
+    stream_meta_t meta;
+    push(in, beats);
+    radar_top_pc(in, out, meta, make_ctrl(n_pulse, 0, true));
+    words.clear();
+    metas.clear();
+    while (!out.empty()) {
+        axis_rd_t beat = out.read();
+        for (int k = 0; k < rd_beat_cells(beat); k++) words.push_back(rd_beat_word(beat, k).to_uint());
+    }
+    while (!meta.empty()) metas.push_back(meta.read());
+    return in.empty();
+}
+
+// 2. 逐脉冲 TLAST，只有脉压：脉冲 5 短包，脉冲 12 长包 (中间多 3 个)，末脉冲长包 (TLAST 前多 1 个)
+static bool test_pulse_tlast() {
+    cout << "[2] radar_top_pc, one TLAST per pulse" << endl;
+    const int n_pulse = 32;
+    bool ok = true;
+    for (int c = 0; c < 2; c++) {
+        vector<uint32_t> ref_w, got_w;
+        vector<pulse_meta_t> ref_m, got_m;
+        run_pc(make_cpi(n_pulse, c, true), n_pulse, ref_w, ref_m);
+
+        vector<axis_in_t> beats = make_cpi(n_pulse, c, true);
+        if (c == 0) {
+            inject(beats, n_pulse - 1, N_RANGE - 1, 1);
+            inject(beats, 12, 60, 3);
+            inject(beats, 5, 100, -1);
+        }
+        bool drained = run_pc(beats, n_pulse, got_w, got_m);
+        if (got_w.size() != ref_w.size() || (int)got_m.size() != n_pulse || !drained) {
+            cout << "   - CPI " << c << ": " << got_w.size() << " cells, " << got_m.size() << " metadata"
+                 << (drained ? "" : ", input not drained") << "  <-- FAIL" << endl;
+            ok = false;
+            continue;
+        }
+        int bad_rows = 0, bad_meta = 0;
+        for (int m = 0; m < n_pulse; m++) {
+            bool same = true;
+            for (int r = 0; r < N_RANGE; r++) same &= got_w[m * N_RANGE + r] == ref_w[m * N_RANGE + r];
+            const bool want_same = !(c == 0 && (m == 5 || m == 12));
+            int want_err = 0;
+            if (c == 0 && m == 5) want_err = 1;
+            if (c == 0 && (m == 12 || m == n_pulse - 1)) want_err = 2;
+            if (same != want_same) bad_rows++;
+            if ((int)got_m[m].rx_err != want_err || got_m[m].timestamp != ref_m[m].timestamp ||
+                got_m[m].pulse_idx != ref_m[m].pulse_idx) bad_meta++;
+        }
+        cout << "   - CPI " << c << (c == 0 ? " (pulse 5 short, pulses 12 / 31 long)" : " (clean)") << ": "
+             << bad_rows << " rows, " << bad_meta << " metadata unexpected" << endl;
+        ok &= bad_rows == 0 && bad_meta == 0;
+    }
+    return ok;
+}
+
+// 3. 预积累 K=2，逐脉冲 TLAST：输入脉冲 9 短包 (第 4 行)，输入脉冲 40 长包 (第 20 行)
+static bool test_presum() {
+    cout << "[3] radar_top, presum K=2, one TLAST per pulse" << endl;
+    radar_ctrl_t ctrl = make_ctrl(32, 1, true);
+    const int n_in = radar_ctrl_in_pulses(ctrl);
+    bool drained = true, ok = true;
+    vector<uint32_t> ref0 = run_top(make_cpi(n_in, 0, true), ctrl, drained);
+    vector<uint32_t> ref1 = run_top(make_cpi(n_in, 1, true), ctrl, drained);
+
+    vector<axis_in_t> beats = make_cpi(n_in, 0, true);
+    inject(beats, 40, 64, 5);
+    inject(beats, 9, 20, -4);
+    vector<uint32_t> got = run_top(beats, ctrl, drained);
+    ok &= check_frame("CPI 0 (row 4 short, row 20 long)", got, ref0, drained, 0x10001, false);
+    got = run_top(make_cpi(n_in, 1, true), ctrl, drained);
+    ok &= check_frame("CPI 1", got, ref1, drained, 0, true);
+    return ok;
+}
+
+// 逐脉冲 TLAST 的一个 CPI：按 (脉冲, 样点, 个数) 注入 (先注入后面的脉冲，位置不受前面影响)，
+// want_err[m] 为第 m 个脉冲应有的 rx_err，rx_err != 0 的脉冲距离像应改变，其余与无错时逐位相同
+struct rx_fault_t { int m, i, n; };
+
+static bool run_pulse_case(const char *name, const rx_fault_t *faults, int n_faults, int cpi) {
+    const int n_pulse = 16;
+    vector<uint32_t> ref_w, got_w;
+    vector<pulse_meta_t> ref_m, got_m;
+    run_pc(make_cpi(n_pulse, cpi, true), n_pulse, ref_w, ref_m);
+
+    vector<axis_in_t> beats = make_cpi(n_pulse, cpi, true);
+    vector<int> want_err(n_pulse, 0);
+    for (int f = 0; f < n_faults; f++) {
+        inject(beats, faults[f].m, faults[f].i, faults[f].n);
+        want_err[faults[f].m] = faults[f].n < 0 ? 1 : 2;
+    }
+    bool drained = run_pc(beats, n_pulse, got_w, got_m);
+    if (got_w.size() != ref_w.size() || (int)got_m.size() != n_pulse || !drained) {
+        cout << "   - " << name << ": " << got_w.size() << " cells, " << got_m.size() << " metadata"
+             << (drained ? "" : ", input not drained") << "  <-- FAIL" << endl;
+        return false;
+    }
+    int bad_rows = 0, bad_meta = 0;
+    for (int m = 0; m < n_pulse; m++) {
+        bool same = true;
+        for (int r = 0; r < N_RANGE; r++) same &= got_w[m * N_RANGE + r] == ref_w[m * N_RANGE + r];
+        if (same != (want_err[m] == 0)) bad_rows++;
+        if ((int)got_m[m].rx_err != want_err[m] || got_m[m].pulse_idx != ref_m[m].pulse_idx) bad_meta++;
+    }
+    cout << "   - " << name << ": " << bad_rows << " rows, " << bad_meta << " metadata unexpected" << endl;
+    return bad_rows == 0 && bad_meta == 0;
+}
+
+// 4. 逐脉冲 TLAST，开头的脉冲出错
+static bool test_pulse_tlast_start() {
+    cout << "[4] radar_top_pc, one TLAST per pulse, errors from the first pulse" << endl;
+    bool ok = true;
+    const rx_fault_t long_first[1] = { { 0, 50, 3 } };
+    ok &= run_pulse_case("pulse 0 long (3 extra)", long_first, 1, 2);
+    const rx_fault_t short_long[2] = { { 1, 70, 2 }, { 0, 30, -1 } };
+    ok &= run_pulse_case("pulse 0 short, pulse 1 long", short_long, 2, 3);
+    const rx_fault_t long_long[2] = { { 1, 10, 1 }, { 0, 100, 4 } };
+    ok &= run_pulse_case("pulses 0 and 1 long", long_long, 2, 4);
+    return ok;
+}
+
+int main() {
+    cout << ">> [TB] Starting input TLAST resync test..." << endl;
+    bool ok = true;
+    ok &= test_call_tlast();
+    ok &= test_pulse_tlast();
+    ok &= test_presum();
+    ok &= test_pulse_tlast_start();
+    if (!ok) {
+        cout << ">> [FAIL] Input framing errors were not contained to the affected pulse / CPI." << endl;
+        return 1;
+    }
+    cout << ">> [PASS] Framing errors are flagged and the following pulses / CPIs realign." << endl;
+    return 0;
+}
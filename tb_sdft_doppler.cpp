@@ -0,0 +1,182 @@
+#include "radar_defines.h"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <complex>
+#include <cmath>
+
+using namespace std;
+
+// =========================================================
+// 滑动 DFT 多普勒 Testbench
+// 1. 连续送入 1.5 个 CPI 的脉冲 (第 N_PULSE 个之后从头循环)，第 0 个脉冲置 reset
+// 2. 每个脉冲后读出 N_RANGE * n_bins 个单元，与双精度加权 DFT 逐单元比较
+//    参考输入取同一脉压函数的输出，因此只检验递推本身的定点误差
+// 3. 窗口刚满 (第 N_PULSE-1 个脉冲) 时检查目标 (距离门 50 / bin 32) 是否为最强单元
+// 4. 中途更换 bin 列表并 reset，验证重新开始累积
+// =========================================================
+
+const double TOL = 2e-3;          // 单元绝对误差容限 (满量程 1.0)
+const int TGT_GATE = 50;
+const int TGT_BIN = 32;
+
+typedef complex<double> cplx;
+
+static void make_pulse(const vector<int> &re, const vector<int> &im, int p, int seq,
+                       stream_in_t &s) {
+    for (int r = 0; r < N_RANGE; r++) {
+        axis_in_t pkt;
+        ap_int<14> r_14 = re[p * N_RANGE + r];
+        ap_int<14> i_14 = im[p * N_RANGE + r];
+        pkt.data = 0;
+        pkt.data.range(13, 0) = r_14;
+        pkt.data.range(29, 16) = i_14;
+        pkt.last = (r == N_RANGE - 1);
+        pkt.keep = 0xF;
+        pkt.strb = 0xF;
+        pulse_meta_t m;
+        m.timestamp = seq * 1000;
+        m.pulse_idx = seq;
+        m.waveform = 1;
+        m.channel = 0;
+        pkt.user = (r == 0) ? pulse_meta_pack(m) : ap_uint<PULSE_META_W>(0);
+        s.write(pkt);
+    }
+}
+
+int main() {
+    cout << ">> [TB] Starting sliding-DFT Doppler test..." << endl;
+
+    ifstream file_in("input_stimulus.dat");
+    if (!file_in.is_open()) {
+        cout << "ERROR: Cannot open input_stimulus.dat!" << endl;
+        return 1;
+    }
+    vector<int> in_re(N_PULSE * N_RANGE, 0), in_im(N_PULSE * N_RANGE, 0);
+    for (int n = 0; n < N_PULSE * N_RANGE && file_in >> in_re[n] >> in_im[n]; n++) {}
+
+    const double r_damp = 1.0 - 1.0 / (double)(1 << SDFT_DAMP_SHIFT);
+    const double out_scale = 1.0 / (double)(1 << SDFT_OUT_SHIFT);
+    const int n_total = N_PULSE + N_PULSE / 2;
+    const int switch_at = N_PULSE + N_PULSE / 4;   // 在此更换 bin 列表
+
+    sdft_ctrl_t ctrl;
+    const int bins_a[SDFT_MAX_BINS] = { 0, 1, 31, 32, 33, 64, 96, 127 };
+    const int bins_b[SDFT_MAX_BINS] = { 30, 32, 34, 0, 0, 0, 0, 0 };
+    ctrl.n_bins = SDFT_MAX_BINS;
+    for (int i = 0; i < SDFT_MAX_BINS; i++) ctrl.bin[i] = bins_a[i % 8] % N_PULSE;
+
+    vector<vector<cplx> > pc_hist;   // 复位以来的脉压输出 (参考输入)
+    double max_err = 0.0;
+    int errors = 0;
+    bool peak_ok = false;
+
+    for (int n = 0; n < n_total; n++) {
+        int p = n % N_PULSE;
+        ctrl.reset = (n == 0);
+        if (n == switch_at) {
+            ctrl.n_bins = 3;
+            for (int i = 0; i < SDFT_MAX_BINS; i++) ctrl.bin[i] = bins_b[i % 8] % N_PULSE;
+            ctrl.reset = 1;
+        }
+        if (ctrl.reset) pc_hist.clear();
+
+        // 参考：单独跑一次脉压
+        {
+            stream_in_t ref_in;
+            stream_out_t ref_out;
+            stream_meta_t ref_meta;
+            make_pulse(in_re, in_im, p, n, ref_in);
+            pulse_compression(ref_in, ref_out, ref_meta);
+            ref_meta.read();
+            vector<cplx> x(N_RANGE);
+            for (int r = 0; r < N_RANGE; r++) {
+                axis_out_t o = ref_out.read();
+                x[r] = cplx(o.data.re.to_double(), o.data.im.to_double());
+            }
+            pc_hist.push_back(x);
+        }
+
+        stream_in_t in_strm;
+        stream_rd_t out_strm;
+        stream_meta_t meta_strm;
+        make_pulse(in_re, in_im, p, n, in_strm);
+        radar_sdft_top(in_strm, out_strm, meta_strm, ctrl);
+
+        pulse_meta_t m = meta_strm.read();
+        if ((int)m.pulse_idx != n) {
+            cout << ">> [FAIL] pulse " << n << ": meta pulse_idx = " << m.pulse_idx << endl;
+            errors++;
+        }
+
+        // 读出本脉冲 RD 切片
+        int nb = ctrl.n_bins;
+        vector<cplx> dut(N_RANGE * nb);
+        int cells = 0, beats = 0;
+        bool last_ok = true;
+        while (cells < N_RANGE * nb && !out_strm.empty()) {
+            axis_rd_t beat = out_strm.read();
+            int k_n = rd_beat_cells(beat);
+            for (int k = 0; k < k_n && cells < N_RANGE * nb; k++) {
+                my_complex_t c = rd_beat_cell(beat, k);
+                dut[cells++] = cplx(c.re.to_double(), c.im.to_double());
+            }
+            beats++;
+            if ((bool)beat.last != (cells == N_RANGE * nb)) last_ok = false;
+        }
+        if (cells != N_RANGE * nb || !out_strm.empty() || !last_ok) {
+            cout << ">> [FAIL] pulse " << n << ": got " << cells << " cells, TLAST "
+                 << (last_ok ? "ok" : "misplaced") << endl;
+            errors++;
+            continue;
+        }
+
+        // 双精度参考：最近 min(N_PULSE, 已收脉冲数) 个脉冲的加权 DFT
+        int len = (int)pc_hist.size();
+        int w = len < N_PULSE ? len : N_PULSE;
+        double pulse_err = 0.0;
+        for (int r = 0; r < N_RANGE; r++) {
+            for (int i = 0; i < nb; i++) {
+                int k = ctrl.bin[i];
+                cplx acc(0, 0);
+                for (int j = 0; j < w; j++) {
+                    // j = 0 为最新脉冲，窗口内序号 m = N_PULSE-1-j
+                    int m_idx = N_PULSE - 1 - j;
+                    double ph = -2.0 * M_PI * k * m_idx / N_PULSE;
+                    acc += pc_hist[len - 1 - j][r] * pow(r_damp, j + 1) * polar(1.0, ph);
+                }
+                double err = abs(acc * out_scale - dut[r * nb + i]);
+                if (err > pulse_err) pulse_err = err;
+            }
+        }
+        if (pulse_err > max_err) max_err = pulse_err;
+        if (pulse_err > TOL) {
+            cout << ">> [FAIL] pulse " << n << ": max error " << pulse_err << endl;
+            errors++;
+        }
+
+        // 窗口刚满：目标应为最强单元
+        if (n == N_PULSE - 1) {
+            int best = 0;
+            for (int c = 1; c < N_RANGE * nb; c++) {
+                if (abs(dut[c]) > abs(dut[best])) best = c;
+            }
+            int g = best / nb, k = ctrl.bin[best % nb];
+            cout << ">> [TB] Full window peak: gate " << g << ", bin " << k
+                 << ", |X| = " << abs(dut[best]) << endl;
+            peak_ok = (g == TGT_GATE && k == TGT_BIN);
+        }
+    }
+
+    cout << ">> [TB] " << n_total << " pulses, max |error| = " << max_err << endl;
+    if (!peak_ok) {
+        cout << ">> [FAIL] Target not found at gate " << TGT_GATE << " / bin " << TGT_BIN << endl;
+        errors++;
+    }
+    if (errors) {
+        cout << ">> [FAIL] " << errors << " errors." << endl;
+        return 1;
+    }
+    cout << ">> [PASS] Sliding-DFT output matches reference every pulse." << endl;
+    return 0;
+}
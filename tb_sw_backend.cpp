@@ -0,0 +1,189 @@
+#include "radar_defines.h"
+#include "radar_sw.h"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <cmath>
+#include <chrono>
+
+using namespace std;
+
+// =========================================================
+// 软件后端一致性 Testbench
+// 1. 同一帧激励分别送入定点流水线 radar_top 与 CPU 后端 radar_top_sw
+// 2. 逐点比较 RD 图 (误差以峰值幅度归一化)，并核对峰值位置
+// 3. 再用 100 个脉冲的短 CPI + Hann 窗 (多普勒优先) 重复一次 (补零 / 加窗路径)
+// 4. 统计 CPU 后端单帧耗时
+// =========================================================
+
+const int SHORT_CPI = 100;
+
+static void push_frame(stream_in_t &s, const vector<uint32_t> &words, int n_words) {
+    for (int i = 0; i < n_words; i++) {
+        axis_in_t pkt;
+        pkt.data = words[i];
+        pkt.last = (i == n_words - 1) ? 1 : 0;
+        pkt.keep = -1;
+        pkt.strb = -1;
+        pkt.user = 0;
+        s.write(pkt);
+    }
+}
+
+static void pop_frame(stream_rd_t &s, vector<double> &re, vector<double> &im, ap_uint<32> &hdr_flags) {
+    re.clear();
+    im.clear();
+    // 帧头只取标志字
+    for (int b = 0; b < FRAME_HDR_BEATS && !s.empty(); b++) {
+        axis_rd_t pkt = s.read();
+        for (int k = 0; k < OUT_CELLS_PER_BEAT; k++) {
+            if (b * OUT_CELLS_PER_BEAT + k == 7) hdr_flags = rd_beat_word(pkt, k);
+        }
+    }
+    while (!s.empty()) {
+        axis_rd_t pkt = s.read();
+        for (int k = 0; k < rd_beat_cells(pkt); k++) {
+            my_complex_t c = rd_beat_cell(pkt, k);
+            re.push_back(c.re.to_double());
+            im.push_back(c.im.to_double());
+        }
+    }
+}
+
+static int peak_index(const vector<double> &re, const vector<double> &im) {
+    int idx = 0;
+    double best = -1.0;
+    for (size_t i = 0; i < re.size(); i++) {
+        double m = re[i] * re[i] + im[i] * im[i];
+        if (m > best) { best = m; idx = (int)i; }
+    }
+    return idx;
+}
+
+// 同一帧分别送入 radar_top 与 radar_top_sw 并比较
+static bool compare_backends(const vector<uint32_t> &words, radar_ctrl_t ctrl,
+                             const dop_win_t dop_win[N_PULSE]) {
+    pc_fir_tap_t no_taps[PC_FIR_MAX_TAPS];   // pc_fir_taps = 0，抽头口不读
+    const int samples_per_frame = N_PULSE * N_RANGE;
+    const int n_words = radar_ctrl_pulses(ctrl) * N_RANGE;
+    ap_uint<32> dbg_in = 0, dbg_out = 0, hw_flags = 0, sw_flags = 0;
+
+    cout << ">> [TB] Running fixed-point radar_top (n_pulse=" << radar_ctrl_pulses(ctrl)
+         << ", window " << (ctrl.win_en ? "on" : "off") << ")..." << endl;
+    stream_in_t in_hw("in_hw");
+    stream_rd_t out_hw("out_hw");
+    push_frame(in_hw, words, n_words);
+    radar_top(in_hw, out_hw, ctrl, dop_win, no_taps, &dbg_in, &dbg_out);
+    vector<double> hw_re, hw_im;
+    pop_frame(out_hw, hw_re, hw_im, hw_flags);
+
+    cout << ">> [TB] Running software backend radar_top_sw..." << endl;
+    stream_in_t in_sw("in_sw");
+    stream_rd_t out_sw("out_sw");
+    push_frame(in_sw, words, n_words);
+    radar_top_sw(in_sw, out_sw, ctrl, dop_win, no_taps, &dbg_in, &dbg_out);
+    vector<double> sw_re, sw_im;
+    pop_frame(out_sw, sw_re, sw_im, sw_flags);
+
+    if (hw_re.size() != (size_t)samples_per_frame || sw_re.size() != (size_t)samples_per_frame) {
+        cout << ">> [FAIL] Output size mismatch: HW=" << hw_re.size() << ", SW=" << sw_re.size() << endl;
+        return false;
+    }
+    if (hw_flags != sw_flags || (int)hw_flags.range(31, 16) != radar_ctrl_pulses(ctrl)) {
+        cout << ">> [FAIL] Header flags mismatch: HW=0x" << hex << hw_flags.to_uint()
+             << ", SW=0x" << sw_flags.to_uint() << dec << endl;
+        return false;
+    }
+
+    // --- 比较 ---
+    int hw_peak = peak_index(hw_re, hw_im);
+    int sw_peak = peak_index(sw_re, sw_im);
+    double peak_mag = sqrt(hw_re[hw_peak] * hw_re[hw_peak] + hw_im[hw_peak] * hw_im[hw_peak]);
+    double max_err = 0.0;
+    for (int i = 0; i < samples_per_frame; i++) {
+        double e = hypot(hw_re[i] - sw_re[i], hw_im[i] - sw_im[i]);
+        if (e > max_err) max_err = e;
+    }
+    double rel_err_db = 20.0 * log10(max_err / peak_mag + 1e-12);
+
+    int n_inner = ctrl.dop_major ? N_RANGE : N_PULSE;
+    int hw_r = ctrl.dop_major ? hw_peak % n_inner : hw_peak / n_inner;
+    int hw_d = ctrl.dop_major ? hw_peak / n_inner : hw_peak % n_inner;
+    int sw_r = ctrl.dop_major ? sw_peak % n_inner : sw_peak / n_inner;
+    int sw_d = ctrl.dop_major ? sw_peak / n_inner : sw_peak % n_inner;
+    cout << "   - HW Peak @ Range: " << hw_r << ", Doppler: " << hw_d << endl;
+    cout << "   - SW Peak @ Range: " << sw_r << ", Doppler: " << sw_d << endl;
+    cout << "   - Max |HW - SW| = " << max_err << " (" << rel_err_db << " dB re. peak)" << endl;
+
+    // 定点截断误差约为 16 位 LSB 的若干倍，-40 dB 为宽松门限
+    return hw_peak == sw_peak && rel_err_db < -40.0;
+}
+
+int main() {
+    const int samples_per_frame = N_PULSE * N_RANGE;
+
+    ifstream file_in("input_stimulus.dat");
+    if (!file_in.is_open()) {
+        cout << "ERROR: Cannot open input_stimulus.dat!" << endl;
+        return 1;
+    }
+
+    // 按 axis_in_t 格式打包
+    vector<uint32_t> words(samples_per_frame, 0);
+    int re_in, im_in, n = 0;
+    while (n < samples_per_frame && file_in >> re_in >> im_in) {
+        ap_uint<32> w = 0;
+        ap_int<14> r_14 = re_in;
+        ap_int<14> i_14 = im_in;
+        w.range(13, 0) = r_14;
+        w.range(29, 16) = i_14;
+        words[n++] = w.to_uint();
+    }
+    file_in.close();
+
+    dop_win_t dop_win[N_PULSE];
+    for (int p = 0; p < N_PULSE; p++) dop_win[p] = 1;
+    radar_ctrl_t ctrl = {};
+    ctrl.dop_major = 0;
+    ctrl.dop_shift = 0;
+    ctrl.n_pulse = N_PULSE;
+    ctrl.win_en = 0;
+    ctrl.presum_log2 = 0;
+    ctrl.presum_fcw = 0;
+    ctrl.dop_first = 0;
+    ctrl.dop_bins = 0;
+    ctrl.pc_fir_taps = 0;
+    ctrl.tlast_pulse = 0;
+    bool full_ok = compare_backends(words, ctrl, dop_win);
+
+    // 短 CPI：前 SHORT_CPI 个脉冲，Hann 窗，补零到 N_PULSE
+    for (int p = 0; p < N_PULSE; p++) {
+        dop_win[p] = p < SHORT_CPI ? 0.5 - 0.5 * cos(2.0 * M_PI * p / (SHORT_CPI - 1)) : 0.0;
+    }
+    ctrl.n_pulse = SHORT_CPI;
+    ctrl.win_en = 1;
+#ifndef CT_COMPRESS
+    ctrl.dop_major = 1;   // 同时覆盖多普勒优先路径的列读取
+#endif
+    bool short_ok = compare_backends(words, ctrl, dop_win);
+
+    // --- 计时 (原始缓冲区接口，不含流转换) ---
+    const int NUM_FRAMES = 200;
+    RadarSwBackend backend;
+    vector<float> out_iq(samples_per_frame * 2);
+    backend.process(words.data(), out_iq.data());
+    auto t0 = chrono::steady_clock::now();
+    for (int f = 0; f < NUM_FRAMES; f++) {
+        backend.process(words.data(), out_iq.data());
+    }
+    auto t1 = chrono::steady_clock::now();
+    double us = chrono::duration<double, micro>(t1 - t0).count() / NUM_FRAMES;
+    cout << "   - SW backend: " << us << " us/frame (" << backend.threads() << " threads)" << endl;
+
+    if (full_ok && short_ok) {
+        cout << ">> [PASS] Software backend matches fixed-point pipeline." << endl;
+        return 0;
+    }
+    cout << ">> [FAIL] Software backend deviates from fixed-point pipeline!" << endl;
+    return 1;
+}